@@ -0,0 +1,53 @@
+#include "AssignableDisposable.h"
+
+#include <utility>
+
+void AssignableDisposable::SetInner(std::shared_ptr<Disposable> disposable)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!IsDisposed())
+        {
+            inner = std::move(disposable);
+            // 以降の廃棄は中身から伝わる
+            linked.clear();
+            return;
+        }
+    }
+
+    if (disposable != nullptr) disposable->Dispose();
+}
+
+void AssignableDisposable::Link(std::shared_ptr<Disposable> disposable)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!IsDisposed())
+        {
+            linked.emplace_back(std::move(disposable));
+            return;
+        }
+    }
+
+    disposable->Dispose();
+}
+
+void AssignableDisposable::Dispose()
+{
+    std::shared_ptr<Disposable> d;
+    decltype(linked) l;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (IsDisposed()) return;
+
+        Disposable::Dispose();
+        d = std::move(inner);
+        l = std::move(linked);
+    }
+
+    if (d != nullptr) d->Dispose();
+    for (auto&& e : l)
+    {
+        e->Dispose();
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "Disposable.h"
+#include "RxPool.h"
+
+// 後から中身の購読が決まるDisposable (SubscribeOnのように購読が遅れて行われる場合に使う)
+// 中身が決まる前にDisposeされた場合は、決まった時点で中身をDisposeする
+class AssignableDisposable : public Disposable
+{
+    std::mutex mutex;
+    std::shared_ptr<Disposable> inner;
+    // 中身が決まるまでの間に結び付けられた購読 (購読中にその場で値を流す発行元のもの)
+    std::vector<std::shared_ptr<Disposable>, RxPool::Allocator<std::shared_ptr<Disposable>>> linked;
+
+    struct Pending
+    {
+        AssignableDisposable* subscription;
+        const Pending* parent;
+    };
+
+    static const Pending*& CurrentPending()
+    {
+        static thread_local const Pending* current = nullptr;
+        return current;
+    }
+
+public:
+    void SetInner(std::shared_ptr<Disposable> disposable);
+    void Dispose() override;
+
+    // 中身が決まるまでの間、廃棄を伝える購読を結び付ける (廃棄済みならその場で廃棄する)
+    void Link(std::shared_ptr<Disposable> disposable);
+
+    // 上流へ購読している途中のAssignableDisposable (Take等のオペレータが上流のSubscribeを呼ぶ間だけ設定する)
+    // nullptrを渡すと連なりを切る (値を流す間に始まった別の購読が、流している購読の廃棄を引き継がないように)
+    class PendingScope
+    {
+        Pending pending;
+        const Pending* saved;
+
+    public:
+        explicit PendingScope(AssignableDisposable* subscription)
+            : pending{subscription, CurrentPending()},
+              saved(CurrentPending())
+        {
+            CurrentPending() = subscription != nullptr ? &pending : nullptr;
+        }
+        ~PendingScope() { CurrentPending() = saved; }
+
+        PendingScope(const PendingScope&) = delete;
+        PendingScope& operator=(const PendingScope&) = delete;
+    };
+
+    // 購読中にその場で値を流す発行元用。上流へ購読している途中の全てのAssignableDisposableへ結び付け、
+    // Subscribeが戻る前に下流(Take等)で廃棄されてもdisposableに届くようにする
+    static void LinkPending(const std::shared_ptr<Disposable>& disposable)
+    {
+        for (auto p = CurrentPending(); p != nullptr; p = p->parent)
+        {
+            p->subscription->Link(disposable);
+        }
+    }
+};
@@ -0,0 +1,87 @@
+#pragma once
+#include <memory>
+
+#include "Disposable.h"
+#include "Observable.h"
+#include "Observer.h"
+#include "RxPool.h"
+#include "Subject.h"
+
+// 最新の値を持ち、購読時にその値を流してから以降の値を流すサブジェクト
+// 完了後に購読した場合は完了だけを流す
+template <typename T>
+class BehaviorSubject
+{
+    Subject<T> subject;
+    T latest;
+    bool completed = false;
+
+public:
+    explicit BehaviorSubject(T initial): latest(std::move(initial))
+    {
+    }
+
+    BehaviorSubject(const BehaviorSubject&) = delete;
+    BehaviorSubject& operator=(const BehaviorSubject&) = delete;
+
+    const T& Value() const { return latest; }
+
+    void OnNext(const T& v)
+    {
+        if (completed) return;
+
+        latest = v;
+        subject.OnNext(v);
+    }
+
+    void OnNextBatch(const T* data, size_t n)
+    {
+        if (completed || n == 0) return;
+
+        latest = data[n - 1];
+        subject.OnNextBatch(data, n);
+    }
+
+    void OnCompleted()
+    {
+        if (completed) return;
+
+        completed = true;
+        subject.OnCompleted();
+    }
+
+    std::shared_ptr<Observable<T>> GetObservable()
+    {
+        auto inner = subject.GetObservable();
+
+        auto observable = RxPool::MakeShared<Observable<T>>(
+            [this, inner](ObserverPtr<T> o) -> std::shared_ptr<Disposable>
+            {
+                if (completed)
+                {
+                    o->OnCompleted();
+
+                    // 登録はしないので、廃棄済みのものを返す
+                    auto d = RxPool::MakeShared<Disposable>();
+                    d->Dispose();
+                    return d;
+                }
+
+                o->OnNext(latest);
+                return inner->Subscribe(o);
+            },
+            inner->GetDisposable(),
+            nullptr
+        );
+        observable->AttachNode(subject.GetNode());
+        return observable;
+    }
+
+    Instrumentation::Node GetNode() const { return subject.GetNode(); }
+
+    template <typename... Ops>
+    std::shared_ptr<PipeObservable<T, Ops...>> Pipe(Ops... ops)
+    {
+        return GetObservable()->Pipe(std::move(ops)...);
+    }
+};
@@ -0,0 +1,124 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "../RxPool.h"
+
+// ベンチマーク計測用の簡易ハーネス
+// 1回の計測(繰り返し)でops回の操作を行う処理を、ウォームアップ後にrepetitions回計測し、
+// 1操作あたりの中央値/p99、ops/sec、1操作あたりのアロケーション回数(大域/RxPool)を記録する
+namespace Bench
+{
+    // グローバルoperator newの呼び出し回数 (BenchMain.cppで計数)
+    size_t AllocationCount();
+
+    struct Result
+    {
+        std::string name;
+        size_t opsPerRepetition;
+        double medianNs; // 1操作あたり
+        double p99Ns; // 1操作あたり
+        double opsPerSec;
+        double allocsPerOp;
+        double poolAllocsPerOp; // 計測スレッドでRxPoolから払い出した回数
+    };
+
+    class Runner
+    {
+        int warmup;
+        int repetitions;
+        std::string filter;
+        std::vector<Result> results;
+
+        static double Percentile(std::vector<double> samples, double p)
+        {
+            std::sort(samples.begin(), samples.end());
+            const auto index = static_cast<size_t>(p * static_cast<double>(samples.size() - 1) + 0.5);
+            return samples[std::min(index, samples.size() - 1)];
+        }
+
+    public:
+        Runner(int warmup, int repetitions, std::string filter)
+            : warmup(warmup),
+              repetitions(repetitions),
+              filter(std::move(filter))
+        {
+        }
+
+        // body()は1回の呼び出しでops回の操作を行うこと
+        void Run(const std::string& name, size_t ops, const std::function<void()>& body)
+        {
+            if (!filter.empty() && name.find(filter) == std::string::npos) return;
+
+            for (int i = 0; i < warmup; ++i)
+            {
+                body();
+            }
+
+            std::vector<double> samples;
+            samples.reserve(repetitions);
+
+            const auto allocBegin = AllocationCount();
+            const auto poolAllocBegin = RxPool::ThreadAllocationCount();
+            for (int i = 0; i < repetitions; ++i)
+            {
+                const auto begin = std::chrono::steady_clock::now();
+                body();
+                const std::chrono::duration<double, std::nano> ns = std::chrono::steady_clock::now() - begin;
+                samples.push_back(ns.count() / static_cast<double>(ops));
+            }
+            // 計測用vectorの確保はループ前に済ませているので含まれない
+            const auto allocs = AllocationCount() - allocBegin;
+            const auto poolAllocs = RxPool::ThreadAllocationCount() - poolAllocBegin;
+
+            Result result;
+            result.name = name;
+            result.opsPerRepetition = ops;
+            result.medianNs = Percentile(samples, 0.5);
+            result.p99Ns = Percentile(samples, 0.99);
+            result.opsPerSec = result.medianNs > 0 ? 1e9 / result.medianNs : 0;
+            result.allocsPerOp = static_cast<double>(allocs) / (static_cast<double>(ops) * repetitions);
+            result.poolAllocsPerOp = static_cast<double>(poolAllocs) / (static_cast<double>(ops) * repetitions);
+            results.push_back(result);
+        }
+
+        void WriteCsv(std::ostream& os) const
+        {
+            os << "name,ops,median_ns,p99_ns,ops_per_sec,allocs_per_op,pool_allocs_per_op\n";
+            for (auto&& r : results)
+            {
+                os << r.name << ',' << r.opsPerRepetition << ',' << r.medianNs << ',' << r.p99Ns << ','
+                    << r.opsPerSec << ',' << r.allocsPerOp << ',' << r.poolAllocsPerOp << '\n';
+            }
+        }
+
+        void WriteJson(std::ostream& os) const
+        {
+            os << "[\n";
+            for (size_t i = 0; i < results.size(); ++i)
+            {
+                auto&& r = results[i];
+                os << "  {\"name\": \"" << r.name << "\", \"ops\": " << r.opsPerRepetition
+                    << ", \"median_ns\": " << r.medianNs << ", \"p99_ns\": " << r.p99Ns
+                    << ", \"ops_per_sec\": " << r.opsPerSec << ", \"allocs_per_op\": " << r.allocsPerOp
+                    << ", \"pool_allocs_per_op\": " << r.poolAllocsPerOp << "}"
+                    << (i + 1 < results.size() ? ",\n" : "\n");
+            }
+            os << "]\n";
+        }
+    };
+
+    // 最適化で計算が消されないようにするための書き込み先 (BenchMain.cppで定義)
+    extern volatile unsigned char doNotOptimizeSink;
+
+    template <typename T>
+    void DoNotOptimize(const T& v)
+    {
+        doNotOptimizeSink = *reinterpret_cast<const volatile unsigned char*>(&v);
+    }
+}
@@ -0,0 +1,107 @@
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <type_traits>
+
+#include "BenchHarness.h"
+#include "ConcurrentBench.h"
+#include "EventLogBench.h"
+#include "MappedFileBench.h"
+#include "OperatorBench.h"
+#include "SchedulerBench.h"
+#include "SubjectBench.h"
+
+volatile unsigned char Bench::doNotOptimizeSink;
+
+// 計測無効時はノードが空であり、Subject/Observableに何も追加されていないこと
+#if !RX_INSTRUMENTATION
+static_assert(std::is_empty<Instrumentation::Node>::value, "instrumentation must compile to nothing when disabled");
+#endif
+
+// --- アロケーション計数 ---
+static std::atomic<size_t> allocationCount{0};
+
+// 置き換えたoperator new/deleteがmalloc/freeで対になっていることをGCCが追えずに警告するため
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+size_t Bench::AllocationCount()
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+void* operator new(size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (auto p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+// 使い方: Rx_bench [--format=csv|json] [--out=path] [--filter=name] [--reps=N] [--warmup=N]
+int main(int argc, char** argv)
+{
+    std::string format = "csv";
+    std::string out;
+    std::string filter;
+    int reps = 20;
+    int warmup = 3;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const auto value = arg.substr(arg.find('=') + 1);
+
+        if (arg.find("--format=") == 0) format = value;
+        else if (arg.find("--out=") == 0) out = value;
+        else if (arg.find("--filter=") == 0) filter = value;
+        else if (arg.find("--reps=") == 0) reps = std::max(1, std::atoi(value.c_str()));
+        else if (arg.find("--warmup=") == 0) warmup = std::max(0, std::atoi(value.c_str()));
+        else
+        {
+            std::cerr << "Usage: Rx_bench [--format=csv|json] [--out=path] [--filter=name] [--reps=N] [--warmup=N]"
+                << std::endl;
+            return 1;
+        }
+    }
+
+    // 計測の有無で結果を比較できるよう、どちらでビルドしたかを出しておく
+    std::cerr << "instrumentation: " << (RX_INSTRUMENTATION ? "on" : "off") << std::endl;
+    // 購読1つあたりの常駐サイズの目安
+    std::cerr << "sizeof: Function=" << sizeof(Function<void(const int&)>)
+        << " Observer<int>=" << sizeof(Observer<int>)
+        << " Observable<int>=" << sizeof(Observable<int>) << std::endl;
+
+    Bench::Runner runner(warmup, reps, filter);
+
+    OperatorBench::Run(runner);
+    SubjectBench::Run(runner);
+    ConcurrentBench::Run(runner);
+    SchedulerBench::Run(runner);
+    EventLogBench::Run(runner);
+    MappedFileBench::Run(runner);
+
+    std::ofstream file;
+    if (!out.empty()) file.open(out);
+    std::ostream& os = out.empty() ? std::cout : file;
+
+    if (format == "json") runner.WriteJson(os);
+    else runner.WriteCsv(os);
+
+    // メモリーリークチェックのタイミングではリークとして検知されてしまうので解放しておく
+    ObservableUtil::everyUpdateSubject = nullptr;
+    FrameTimerWheel::Main().Clear();
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "../ConcurrentSubject.h"
+#include "../Subject.h"
+
+// ConcurrentSubjectとmutexで保護したSubjectの、発行スレッド数ごとのスループット
+namespace ConcurrentBench
+{
+    // 比較用: 全操作をmutexで直列化したSubject
+    template <typename T>
+    class MutexSubject
+    {
+        Subject<T> subject;
+        std::mutex mutex;
+
+    public:
+        void OnNext(const T& v)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            subject.OnNext(v);
+        }
+
+        std::shared_ptr<Disposable> Subscribe(std::function<void(const T&)> onNext)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return subject.GetObservable()->Subscribe(std::move(onNext));
+        }
+    };
+
+    constexpr int SubscriberCount = 8;
+    constexpr size_t EmitCount = 100000; // 1スレッドあたり
+
+    // 登録する処理はスレッドごとの変数にだけ書き込む (処理自体が競合しないように)
+    inline void Work(int v)
+    {
+        static thread_local unsigned sink = 0;
+        sink = sink * 31 + static_cast<unsigned>(v);
+    }
+
+    inline void Emit(int threadCount, const std::function<void(int)>& emit)
+    {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; t++)
+        {
+            threads.emplace_back([&]
+            {
+                for (size_t i = 0; i < EmitCount; i++)
+                {
+                    emit(static_cast<int>(i));
+                }
+            });
+        }
+        for (auto&& t : threads)
+        {
+            t.join();
+        }
+    }
+
+    inline void Run(Bench::Runner& runner)
+    {
+        auto concurrent = std::make_shared<ConcurrentSubject<int>>();
+        auto mutexed = std::make_shared<MutexSubject<int>>();
+
+        std::vector<std::shared_ptr<Disposable>> disposers;
+        for (int i = 0; i < SubscriberCount; i++)
+        {
+            disposers.emplace_back(concurrent->GetObservable()->Subscribe([](int v) { Work(v); }));
+            disposers.emplace_back(mutexed->Subscribe([](int v) { Work(v); }));
+        }
+
+        const auto maxThreads = std::max(2, static_cast<int>(std::thread::hardware_concurrency()));
+        for (int threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+        {
+            const auto ops = EmitCount * threadCount;
+            runner.Run("concurrent/lockfree/" + std::to_string(threadCount), ops, [&]
+            {
+                Emit(threadCount, [&](int v) { concurrent->OnNext(v); });
+            });
+            runner.Run("concurrent/mutex/" + std::to_string(threadCount), ops, [&]
+            {
+                Emit(threadCount, [&](int v) { mutexed->OnNext(v); });
+            });
+        }
+
+        for (auto&& d : disposers)
+        {
+            d->Dispose();
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "BenchHarness.h"
+#include "../EventLog.h"
+#include "../Subject.h"
+
+// 記録/再生のコスト
+namespace EventLogBench
+{
+    inline void Run(Bench::Runner& runner)
+    {
+        constexpr size_t ops = 100000;
+        const std::string path = "rx_bench_eventlog.bin";
+
+        struct Event
+        {
+            int id;
+            float x;
+            float y;
+        };
+
+        // 記録する側(通知するスレッド)の1値あたりのコスト。書き出しはライタースレッドで行われる
+        {
+            const auto subject = std::make_shared<Subject<Event>>();
+            const auto writer = std::make_shared<EventLogWriter>(path, static_cast<uint32_t>(sizeof(Event)));
+            long long sink = 0;
+            auto d = subject->GetObservable()
+                            ->Record(writer)
+                            ->Subscribe([&](const Event& e) { sink += e.id; });
+
+            runner.Run("eventlog/record", ops, [&]
+            {
+                for (size_t i = 0; i < ops; ++i)
+                {
+                    subject->OnNext(Event{static_cast<int>(i), 1.0f, 2.0f});
+                }
+            });
+            Bench::DoNotOptimize(sink);
+
+            d->Dispose();
+            writer->Close();
+        }
+
+        // 記録したログをその場で全て流し直す1値あたりのコスト (読み込み込み)
+        {
+            const auto subject = std::make_shared<Subject<Event>>();
+            long long sink = 0;
+            auto d = subject->GetObservable()->Subscribe([&](const Event& e) { sink += e.id; });
+
+            // 計測時のログの値の数はreps(と、ウォームアップ)の回数に比例するので、1回分だけのログを作り直す
+            {
+                EventLogWriter writer(path, static_cast<uint32_t>(sizeof(Event)));
+                for (size_t i = 0; i < ops; ++i)
+                {
+                    const Event e{static_cast<int>(i), 1.0f, 2.0f};
+                    writer.Append(i / 100, &e, 1); // 1フレームに100値
+                }
+            }
+
+            runner.Run("eventlog/replay/fast", ops, [&]
+            {
+                ::Replay(path, subject, ReplayMode::AsFastAsPossible);
+            });
+            Bench::DoNotOptimize(sink);
+
+            d->Dispose();
+        }
+
+        std::remove(path.c_str());
+    }
+}
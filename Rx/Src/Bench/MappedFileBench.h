@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "../ObservableUtil.h"
+#include "../Subject.h"
+
+// ファイルの固定長レコードをWhere/Selectへ流すコスト (1レコードあたり。マップ/読み込み込み)
+namespace MappedFileBench
+{
+    inline void Run(Bench::Runner& runner)
+    {
+        constexpr size_t ops = 1 << 20; // 16MB
+        const std::string path = "rx_bench_mapped.bin";
+
+        struct Record
+        {
+            int id;
+            float x;
+            float y;
+            float z;
+        };
+
+        {
+            auto f = std::fopen(path.c_str(), "wb");
+            std::vector<Record> records(ops);
+            for (size_t i = 0; i < ops; ++i)
+            {
+                records[i] = Record{static_cast<int>(i), 1.0f, 2.0f, 3.0f};
+            }
+            std::fwrite(records.data(), sizeof(Record), records.size(), f);
+            std::fclose(f);
+        }
+
+        auto stream = [&](std::shared_ptr<Observable<Record>> source)
+        {
+            long long sink = 0;
+            auto d = source->Where([](const Record& r) { return (r.id & 1) == 0; })
+                           ->Select<float>([](const Record& r) { return r.x + r.y + r.z; })
+                           ->Subscribe([&](float v) { sink += static_cast<long long>(v); });
+            Bench::DoNotOptimize(sink);
+        };
+
+        // 従来の方法: 読み込んでからSubjectで1件ずつ流す
+        runner.Run("mapped/where_select/read_onnext", ops, [&]
+        {
+            std::vector<Record> records(ops);
+            auto f = std::fopen(path.c_str(), "rb");
+            const auto read = std::fread(records.data(), sizeof(Record), records.size(), f);
+            std::fclose(f);
+
+            const auto subject = std::make_shared<Subject<Record>>();
+            long long sink = 0;
+            auto d = subject->GetObservable()
+                            ->Where([](const Record& r) { return (r.id & 1) == 0; })
+                            ->Select<float>([](const Record& r) { return r.x + r.y + r.z; })
+                            ->Subscribe([&](float v) { sink += static_cast<long long>(v); });
+            for (size_t i = 0; i < read; ++i)
+            {
+                subject->OnNext(records[i]);
+            }
+            Bench::DoNotOptimize(sink);
+        });
+
+        // マップした領域から1件ずつ流す
+        runner.Run("mapped/where_select/single", ops, [&]
+        {
+            stream(ObservableUtil::FromMappedFile<Record>(path, 0, 0));
+        });
+
+        // マップした領域からまとめて流す
+        runner.Run("mapped/where_select/batch", ops, [&]
+        {
+            stream(ObservableUtil::FromMappedFile<Record>(path));
+        });
+
+        std::remove(path.c_str());
+    }
+}
@@ -0,0 +1,313 @@
+#pragma once
+#include <climits>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "../ObservableUtil.h"
+#include "../Span.h"
+#include "../Subject.h"
+
+// オペレータチェーンの段数・方式ごとの1発行あたりのコスト
+namespace OperatorBench
+{
+    constexpr size_t Ops = 100000;
+    constexpr size_t BatchSize = 1024;
+
+    inline void Run(Bench::Runner& runner)
+    {
+        // 1段
+        {
+            const auto subject = std::make_shared<Subject<int>>();
+            long long sink = 0;
+            auto d = subject->GetObservable()
+                            ->Where([](int i) { return i >= 0; })
+                            ->Subscribe([&](int i) { sink += i; });
+
+            runner.Run("chain/1stage/operator", Ops, [&]
+            {
+                for (size_t i = 0; i < Ops; ++i)
+                {
+                    subject->OnNext(static_cast<int>(i));
+                }
+            });
+            Bench::DoNotOptimize(sink);
+            d->Dispose();
+        }
+
+        // 5段 (メソッドチェーン)
+        {
+            const auto subject = std::make_shared<Subject<int>>();
+            long long sink = 0;
+            auto d = subject->GetObservable()
+                            ->Where([](int i) { return i >= 0; })
+                            ->Select<int>([](int i) { return i + 1; })
+                            ->Skip(0)
+                            ->Interval(1)
+                            ->Take(INT_MAX)
+                            ->Subscribe([&](int i) { sink += i; });
+
+            runner.Run("chain/5stage/operator", Ops, [&]
+            {
+                for (size_t i = 0; i < Ops; ++i)
+                {
+                    subject->OnNext(static_cast<int>(i));
+                }
+            });
+            Bench::DoNotOptimize(sink);
+            d->Dispose();
+        }
+
+        // 5段 (Pipe)
+        {
+            const auto subject = std::make_shared<Subject<int>>();
+            long long sink = 0;
+            auto d = subject->Pipe(PipeOp::Where([](int i) { return i >= 0; }),
+                                   PipeOp::Select([](int i) { return i + 1; }),
+                                   PipeOp::Skip(0),
+                                   PipeOp::Interval(1),
+                                   PipeOp::Take(INT_MAX))
+                            ->Subscribe([&](int i) { sink += i; });
+
+            runner.Run("chain/5stage/pipe", Ops, [&]
+            {
+                for (size_t i = 0; i < Ops; ++i)
+                {
+                    subject->OnNext(static_cast<int>(i));
+                }
+            });
+            Bench::DoNotOptimize(sink);
+            d->Dispose();
+        }
+
+        // 5段 (OnNextBatch)
+        {
+            const auto subject = std::make_shared<Subject<int>>();
+            long long sink = 0;
+            auto d = subject->GetObservable()
+                            ->Where([](int i) { return i >= 0; })
+                            ->Select<int>([](int i) { return i + 1; })
+                            ->Skip(0)
+                            ->Interval(1)
+                            ->Take(INT_MAX)
+                            ->Subscribe([&](int i) { sink += i; });
+
+            std::vector<int> values(Ops);
+            for (size_t i = 0; i < Ops; ++i)
+            {
+                values[i] = static_cast<int>(i);
+            }
+
+            runner.Run("chain/5stage/batch", Ops, [&]
+            {
+                for (size_t i = 0; i < Ops; i += BatchSize)
+                {
+                    subject->OnNextBatch(values.data() + i, std::min(BatchSize, Ops - i));
+                }
+            });
+            Bench::DoNotOptimize(sink);
+            d->Dispose();
+        }
+
+        // 1フレームに1000件届く値を、1件ずつ受け取る場合とフレームごとにまとめて受け取る場合
+        {
+            constexpr size_t perFrame = 1000;
+            constexpr size_t frames = Ops / perFrame;
+            const auto subject = std::make_shared<Subject<int>>();
+            long long sink = 0;
+
+            const auto frameLoop = [&]
+            {
+                for (size_t f = 0; f < frames; ++f)
+                {
+                    for (size_t i = 0; i < perFrame; ++i)
+                    {
+                        subject->OnNext(static_cast<int>(i));
+                    }
+                    ObservableUtil::DoEveryUpdate();
+                }
+            };
+
+            auto d = subject->GetObservable()
+                            ->Select<int>([](int i) { return i + 1; })
+                            ->Subscribe([&](int i) { sink += i; });
+            runner.Run("buffer/perframe/callback", Ops, frameLoop);
+            d->Dispose();
+
+            d = subject->GetObservable()
+                       ->BufferFrame(1)
+                       ->Subscribe([&](const Span<int>& s)
+                       {
+                           for (auto i : s)
+                           {
+                               sink += i + 1;
+                           }
+                       });
+            runner.Run("buffer/perframe/span", Ops, frameLoop);
+            d->Dispose();
+            Bench::DoNotOptimize(sink);
+        }
+
+        // Buffer(count)
+        {
+            const auto subject = std::make_shared<Subject<int>>();
+            long long sink = 0;
+            auto d = subject->GetObservable()
+                            ->Buffer(64)
+                            ->Subscribe([&](const Span<int>& s) { sink += s.back(); });
+
+            runner.Run("buffer/count64", Ops, [&]
+            {
+                for (size_t i = 0; i < Ops; ++i)
+                {
+                    subject->OnNext(static_cast<int>(i));
+                }
+            });
+            Bench::DoNotOptimize(sink);
+            d->Dispose();
+        }
+
+        // 1フレームに1000件届く値に対して重めの処理をする場合に、全件処理するか、ThrottleFirstFrame/SampleFrameで間引くか
+        {
+            constexpr size_t perFrame = 1000;
+            constexpr size_t frames = Ops / perFrame;
+            const auto subject = std::make_shared<Subject<int>>();
+            unsigned sink = 0;
+
+            const auto work = [&](int v)
+            {
+                auto seed = static_cast<unsigned>(v);
+                for (int i = 0; i < 100; ++i)
+                {
+                    seed = seed * 1664525u + 1013904223u;
+                }
+                sink += seed;
+            };
+            const auto frameLoop = [&]
+            {
+                for (size_t f = 0; f < frames; ++f)
+                {
+                    for (size_t i = 0; i < perFrame; ++i)
+                    {
+                        subject->OnNext(static_cast<int>(i));
+                    }
+                    ObservableUtil::DoEveryUpdate();
+                }
+            };
+
+            auto d = subject->GetObservable()->Subscribe(work);
+            runner.Run("throttle/perframe/all", Ops, frameLoop);
+            d->Dispose();
+
+            d = subject->GetObservable()->ThrottleFirstFrame(1)->Subscribe(work);
+            runner.Run("throttle/perframe/throttlefirst", Ops, frameLoop);
+            d->Dispose();
+
+            d = subject->GetObservable()->SampleFrame(1)->Subscribe(work);
+            runner.Run("throttle/perframe/sample", Ops, frameLoop);
+            d->Dispose();
+            Bench::DoNotOptimize(sink);
+        }
+
+        // 毎フレーム同じ値を流し直すhpのような値 (100回に1回だけ変わる) に対して、下流で3段の処理をする場合
+        // DistinctUntilChangedを挟むと、下流の呼び出しは1/100になる
+        {
+            const auto subject = std::make_shared<Subject<int>>();
+            long long sink = 0;
+            const auto loop = [&]
+            {
+                for (size_t i = 0; i < Ops; ++i)
+                {
+                    subject->OnNext(static_cast<int>(i / 100));
+                }
+            };
+
+            auto d = subject->GetObservable()
+                            ->Select<int>([](int hp) { return hp * 10; })
+                            ->Where([](int hp) { return hp >= 0; })
+                            ->Select<int>([](int hp) { return hp + 1; })
+                            ->Subscribe([&](int hp) { sink += hp; });
+            runner.Run("distinct/hp/all", Ops, loop);
+            d->Dispose();
+
+            d = subject->GetObservable()
+                       ->DistinctUntilChanged()
+                       ->Select<int>([](int hp) { return hp * 10; })
+                       ->Where([](int hp) { return hp >= 0; })
+                       ->Select<int>([](int hp) { return hp + 1; })
+                       ->Subscribe([&](int hp) { sink += hp; });
+            runner.Run("distinct/hp/distinct", Ops, loop);
+            d->Dispose();
+            Bench::DoNotOptimize(sink);
+        }
+
+        // 重めのSelectを10件の購読者で購読する場合に、購読ごとに評価するか、Shareで1回だけ評価するか
+        {
+            constexpr size_t subscriberCount = 10;
+            const auto subject = std::make_shared<Subject<int>>();
+            long long sink = 0;
+            const auto work = [](int v)
+            {
+                auto seed = static_cast<unsigned>(v);
+                for (int i = 0; i < 100; ++i)
+                {
+                    seed = seed * 1664525u + 1013904223u;
+                }
+                return static_cast<int>(seed);
+            };
+            const auto loop = [&]
+            {
+                for (size_t i = 0; i < Ops; ++i)
+                {
+                    subject->OnNext(static_cast<int>(i));
+                }
+            };
+            const auto run = [&](const char* name, const std::shared_ptr<Observable<int>>& o)
+            {
+                std::vector<std::shared_ptr<Disposable>> disposers;
+                for (size_t i = 0; i < subscriberCount; ++i)
+                {
+                    disposers.emplace_back(o->Subscribe([&](int v) { sink += v; }));
+                }
+                runner.Run(name, Ops, loop);
+                for (auto&& d : disposers)
+                {
+                    d->Dispose();
+                }
+            };
+
+            run("share/10subs/cold", subject->GetObservable()->Select<int>(work));
+            run("share/10subs/shared", subject->GetObservable()->Select<int>(work)->Share());
+            Bench::DoNotOptimize(sink);
+        }
+
+        // 2つのSubjectを組み合わせる場合の、1組(各入力1回ずつ)あたりのコスト
+        {
+            const auto a = std::make_shared<Subject<int>>();
+            const auto b = std::make_shared<Subject<int>>();
+            long long sink = 0;
+            const auto loop = [&]
+            {
+                for (size_t i = 0; i < Ops; ++i)
+                {
+                    a->OnNext(static_cast<int>(i));
+                    b->OnNext(static_cast<int>(i));
+                }
+            };
+
+            auto d = a->GetObservable()
+                      ->CombineLatest(b->GetObservable())
+                      ->Subscribe([&](const std::tuple<int, int>& t) { sink += std::get<0>(t) + std::get<1>(t); });
+            runner.Run("combine/combinelatest2", Ops, loop);
+            d->Dispose();
+
+            d = a->GetObservable()
+                 ->Zip(b->GetObservable())
+                 ->Subscribe([&](const std::tuple<int, int>& t) { sink += std::get<0>(t) + std::get<1>(t); });
+            runner.Run("combine/zip2", Ops, loop);
+            d->Dispose();
+            Bench::DoNotOptimize(sink);
+        }
+    }
+}
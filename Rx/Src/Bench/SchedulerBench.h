@@ -0,0 +1,118 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "BenchHarness.h"
+#include "../Scheduler.h"
+#include "../Subject.h"
+
+// スケジューラのスループット
+namespace SchedulerBench
+{
+    constexpr size_t TaskCount = 20000;
+    constexpr int WorkPerTask = 2000;
+
+    // 重めのSelectを想定した計算
+    inline unsigned Work(unsigned seed)
+    {
+        for (int i = 0; i < WorkPerTask; ++i)
+        {
+            seed = seed * 1664525u + 1013904223u;
+        }
+        return seed;
+    }
+
+    inline void WaitFor(const std::atomic<size_t>& counter, size_t target)
+    {
+        while (counter.load() < target)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    inline void Run(Bench::Runner& runner)
+    {
+        // スレッドプールのワーカー数ごとのタスク処理数 (コア数に応じて伸びること)
+        const auto maxThreads = std::max(2u, std::thread::hardware_concurrency());
+        for (unsigned threadCount = 1; threadCount <= maxThreads; threadCount *= 2)
+        {
+            ThreadPoolScheduler pool(threadCount);
+            std::atomic<size_t> done{0};
+            std::atomic<unsigned> sink{0};
+
+            runner.Run("scheduler/threadpool/" + std::to_string(threadCount), TaskCount, [&]
+            {
+                done.store(0);
+                for (size_t i = 0; i < TaskCount; ++i)
+                {
+                    pool.Schedule([&, i]
+                    {
+                        sink.fetch_add(Work(static_cast<unsigned>(i)), std::memory_order_relaxed);
+                        done.fetch_add(1);
+                    });
+                }
+                WaitFor(done, TaskCount);
+            });
+        }
+
+        // ObserveOnで重い処理をスレッドプールへ逃がした場合の、発行側の1発行あたりのコスト
+        {
+            const auto subject = std::make_shared<Subject<int>>();
+            std::atomic<size_t> done{0};
+            std::atomic<unsigned> sink{0};
+
+            auto d = subject->GetObservable()
+                            ->ObserveOn(Scheduler::ThreadPool())
+                            ->Subscribe([&](int v)
+                            {
+                                sink.fetch_add(Work(static_cast<unsigned>(v)), std::memory_order_relaxed);
+                                done.fetch_add(1);
+                            });
+
+            runner.Run("scheduler/observeon_threadpool", TaskCount, [&]
+            {
+                done.store(0);
+                for (size_t i = 0; i < TaskCount; ++i)
+                {
+                    subject->OnNext(static_cast<int>(i));
+                }
+                WaitFor(done, TaskCount);
+            });
+            d->Dispose();
+        }
+
+        // 上と同じ負荷をOnBackpressureLatestで流した場合 (処理しきれない値は捨て、最新の値だけを処理する)
+        {
+            const auto subject = std::make_shared<Subject<int>>();
+            const auto stats = std::make_shared<BackpressureStats>();
+            std::atomic<size_t> done{0};
+            std::atomic<unsigned> sink{0};
+
+            auto d = subject->GetObservable()
+                            ->OnBackpressureLatest(Scheduler::ThreadPool(), stats)
+                            ->Subscribe([&](int v)
+                            {
+                                sink.fetch_add(Work(static_cast<unsigned>(v)), std::memory_order_relaxed);
+                                done.fetch_add(1);
+                            });
+
+            runner.Run("scheduler/backpressure_latest_threadpool", TaskCount, [&]
+            {
+                done.store(0);
+                const auto droppedBefore = stats->Dropped();
+                for (size_t i = 0; i < TaskCount; ++i)
+                {
+                    subject->OnNext(static_cast<int>(i));
+                }
+                // 捨てられなかった分が処理されるまで待つ
+                while (done.load() + (stats->Dropped() - droppedBefore) < TaskCount)
+                {
+                    std::this_thread::yield();
+                }
+            });
+            d->Dispose();
+        }
+    }
+}
@@ -0,0 +1,284 @@
+﻿#pragma once
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "../ObservableDestroyTrigger.h"
+#include "../ObservableUtil.h"
+#include "../ReplaySubject.h"
+#include "../Subject.h"
+#include "../Unit.h"
+
+// Subjectの配信・登録/廃棄のコスト
+namespace SubjectBench
+{
+    // 購読者数ごとの1発行(全購読者への配信)あたりのコスト
+    inline void FanOut(Bench::Runner& runner, size_t subscriberCount)
+    {
+        const auto ops = std::max<size_t>(1, 1000000 / subscriberCount);
+        const auto subject = std::make_shared<Subject<int>>();
+        long long sink = 0;
+
+        std::vector<std::shared_ptr<Disposable>> disposers;
+        for (size_t i = 0; i < subscriberCount; ++i)
+        {
+            disposers.emplace_back(subject->GetObservable()->Subscribe([&](int v) { sink += v; }));
+        }
+
+        runner.Run("fanout/" + std::to_string(subscriberCount), ops, [&]
+        {
+            for (size_t i = 0; i < ops; ++i)
+            {
+                subject->OnNext(static_cast<int>(i));
+            }
+        });
+        Bench::DoNotOptimize(sink);
+
+        for (auto&& d : disposers)
+        {
+            d->Dispose();
+        }
+    }
+
+    // 独立な購読者への1発行あたりのコスト (逐次と並列配信の比較)
+    // 購読者ごとに少し重めの処理をさせ、自分の要素にだけ書き込む (エンティティごとの毎フレームの更新を想定)
+    inline void ParallelFanOut(Bench::Runner& runner, size_t subscriberCount, bool parallel)
+    {
+        constexpr size_t ops = 20;
+        const auto subject = std::make_shared<Subject<int>>();
+        if (parallel) subject->SetParallelDispatch();
+
+        std::vector<double> state(subscriberCount, 1.0);
+        std::vector<std::shared_ptr<Disposable>> disposers;
+        for (size_t i = 0; i < subscriberCount; ++i)
+        {
+            disposers.emplace_back(subject->GetIndependentObservable()->Subscribe([&state, i](int v)
+            {
+                auto x = state[i];
+                for (int k = 0; k < 16; ++k)
+                {
+                    x = x * 0.999 + v;
+                }
+                state[i] = x;
+            }));
+        }
+
+        runner.Run("fanout/independent/" + std::to_string(subscriberCount) + (parallel ? "/parallel" : "/serial"), ops, [&]
+        {
+            for (size_t i = 0; i < ops; ++i)
+            {
+                subject->OnNext(static_cast<int>(i));
+            }
+        });
+        Bench::DoNotOptimize(state[subscriberCount / 2]);
+
+        for (auto&& d : disposers)
+        {
+            d->Dispose();
+        }
+    }
+
+    // 溜めた値の数ごとの、再生付き購読の再生1件あたりのコスト (購読・廃棄込み)
+    inline void Replay(Bench::Runner& runner, size_t bufferSize)
+    {
+        const auto subject = std::make_shared<ReplaySubject<int>>(bufferSize);
+        long long sink = 0;
+        for (size_t i = 0; i < bufferSize; ++i)
+        {
+            subject->OnNext(static_cast<int>(i));
+        }
+
+        runner.Run("replay/subscribe/" + std::to_string(bufferSize), bufferSize, [&]
+        {
+            subject->GetObservable()->Subscribe([&](int v) { sink += v; })->Dispose();
+            // 廃棄予定の掃除 (溜まっている数は変わらない)
+            subject->OnNext(0);
+        });
+        Bench::DoNotOptimize(sink);
+    }
+
+    inline void Run(Bench::Runner& runner)
+    {
+        FanOut(runner, 1);
+        FanOut(runner, 100);
+        FanOut(runner, 10000);
+
+        ParallelFanOut(runner, 100000, false);
+        ParallelFanOut(runner, 100000, true);
+
+        Replay(runner, 16);
+        Replay(runner, 1024);
+        Replay(runner, 65536);
+
+        // 登録してすぐ廃棄 (1000件の常駐購読者がいる状態で)
+        {
+            constexpr size_t ops = 10000;
+            const auto subject = std::make_shared<Subject<int>>();
+            long long sink = 0;
+
+            std::vector<std::shared_ptr<Disposable>> residents;
+            for (size_t i = 0; i < 1000; ++i)
+            {
+                residents.emplace_back(subject->GetObservable()->Subscribe([&](int v) { sink += v; }));
+            }
+
+            runner.Run("churn/subscribe_dispose", ops, [&]
+            {
+                for (size_t i = 0; i < ops; ++i)
+                {
+                    subject->GetObservable()->Subscribe([&](int v) { sink += v; })->Dispose();
+                }
+                // 廃棄予定の掃除
+                subject->OnNext(0);
+            });
+            Bench::DoNotOptimize(sink);
+        }
+
+        // オペレータ3段のチェーンを購読してすぐ廃棄 (1購読あたりの確保回数を見る)
+        {
+            constexpr size_t ops = 10000;
+            const auto subject = std::make_shared<Subject<int>>();
+            long long sink = 0;
+
+            runner.Run("churn/subscribe_dispose_chain3", ops, [&]
+            {
+                for (size_t i = 0; i < ops; ++i)
+                {
+                    subject->GetObservable()
+                           ->Where([](int v) { return v > 0; })
+                           ->Select<int>([](int v) { return v * 2; })
+                           ->Take(1)
+                           ->Subscribe([&](int v) { sink += v; })
+                           ->Dispose();
+                }
+                // 廃棄予定の掃除
+                subject->OnNext(0);
+            });
+            Bench::DoNotOptimize(sink);
+        }
+
+        // Take(1)による自己廃棄
+        {
+            constexpr size_t ops = 10000;
+            const auto subject = std::make_shared<Subject<int>>();
+            long long sink = 0;
+
+            runner.Run("take/self_dispose", ops, [&]
+            {
+                for (size_t i = 0; i < ops; ++i)
+                {
+                    subject->GetObservable()->Take(1)->Subscribe([&](int v) { sink += v; });
+                    subject->OnNext(1);
+                }
+            });
+            Bench::DoNotOptimize(sink);
+        }
+
+        // 購読を多数持つオブジェクトの一括破棄 (1操作 = 1オブジェクトの購読20個の登録と破棄)
+        {
+            constexpr size_t objects = 1000;
+            constexpr size_t perObject = 20;
+            long long sink = 0;
+
+            struct LifeTimeObject : ObservableDestroyTrigger
+            {
+            };
+
+            auto subject = std::make_shared<Subject<int>>();
+            std::vector<std::shared_ptr<LifeTimeObject>> owners;
+            owners.reserve(objects);
+
+            runner.Run("trigger/destroy/20", objects, [&]
+            {
+                for (size_t i = 0; i < objects; ++i)
+                {
+                    auto owner = std::make_shared<LifeTimeObject>();
+                    for (size_t j = 0; j < perObject; ++j)
+                    {
+                        subject->GetObservable()->Subscribe([&](int v) { sink += v; })->AddTo(owner);
+                    }
+                    owners.emplace_back(std::move(owner));
+                }
+                subject->OnNext(1);
+
+                // 1フレームでまとめて破棄
+                owners.clear();
+                subject->OnNext(1);
+            });
+            Bench::DoNotOptimize(sink);
+        }
+
+        // EveryUpdateへの大量登録
+        for (size_t count : {1000, 10000})
+        {
+            const auto ops = 1000000 / count;
+            long long sink = 0;
+
+            std::vector<std::shared_ptr<Disposable>> disposers;
+            for (size_t i = 0; i < count; ++i)
+            {
+                disposers.emplace_back(ObservableUtil::EveryUpdate()->Subscribe([&](Unit) { ++sink; }));
+            }
+
+            runner.Run("everyupdate/" + std::to_string(count), ops, [&]
+            {
+                for (size_t i = 0; i < ops; ++i)
+                {
+                    ObservableUtil::DoEveryUpdate();
+                }
+            });
+            Bench::DoNotOptimize(sink);
+
+            for (auto&& d : disposers)
+            {
+                d->Dispose();
+            }
+            ObservableUtil::DoEveryUpdate();
+        }
+
+        // 長い周期のフレームタイマーを大量に待機させた場合 (毎フレーム数える場合とタイマーホイールの比較)
+        {
+            constexpr size_t count = 10000;
+            constexpr size_t ops = 1000;
+            long long sink = 0;
+
+            const auto measure = [&](const std::string& name,
+                                     const std::function<std::shared_ptr<Disposable>()>& subscribe)
+            {
+                std::vector<std::shared_ptr<Disposable>> disposers;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    disposers.emplace_back(subscribe());
+                }
+
+                runner.Run(name, ops, [&]
+                {
+                    for (size_t i = 0; i < ops; ++i)
+                    {
+                        ObservableUtil::DoEveryUpdate();
+                    }
+                });
+                Bench::DoNotOptimize(sink);
+
+                for (auto&& d : disposers)
+                {
+                    d->Dispose();
+                }
+                ObservableUtil::DoEveryUpdate();
+            };
+
+            // Observable<Unit>として扱うと通常の(毎フレーム数える)Intervalになる
+            measure("frametimer/count/10000", [&]
+            {
+                std::shared_ptr<Observable<Unit>> everyUpdate = ObservableUtil::EveryUpdate();
+                return everyUpdate->Interval(600)->Subscribe([&](Unit) { ++sink; });
+            });
+            measure("frametimer/wheel/10000", [&]
+            {
+                return ObservableUtil::EveryUpdate()->Interval(600)->Subscribe([&](Unit) { ++sink; });
+            });
+        }
+    }
+}
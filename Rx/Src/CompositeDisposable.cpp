@@ -0,0 +1,110 @@
+#include "CompositeDisposable.h"
+
+#include <utility>
+
+void CompositeDisposable::RemoveDisposed()
+{
+    for (size_t i = 0; i < inlineCount;)
+    {
+        if (inlineItems[i]->IsDisposed())
+        {
+            inlineItems[i] = std::move(inlineItems[--inlineCount]);
+            continue;
+        }
+        ++i;
+    }
+
+    for (size_t i = 0; i < overflow.size();)
+    {
+        if (overflow[i]->IsDisposed())
+        {
+            overflow[i] = std::move(overflow.back());
+            overflow.pop_back();
+            continue;
+        }
+        ++i;
+    }
+
+    // 空いた内部領域へ詰め直す
+    while (inlineCount < InlineCapacity && !overflow.empty())
+    {
+        inlineItems[inlineCount++] = std::move(overflow.back());
+        overflow.pop_back();
+    }
+}
+
+void CompositeDisposable::Add(std::shared_ptr<Disposable> disposable)
+{
+    if (disposable == nullptr) return;
+
+    if (IsDisposed())
+    {
+        disposable->Dispose();
+        return;
+    }
+
+    // 領域を広げる前に、廃棄済みのものを取り除いて空きを作る
+    if (inlineCount == InlineCapacity && overflow.size() == overflow.capacity()) RemoveDisposed();
+
+    if (inlineCount < InlineCapacity)
+    {
+        inlineItems[inlineCount++] = std::move(disposable);
+        return;
+    }
+
+    overflow.emplace_back(std::move(disposable));
+}
+
+bool CompositeDisposable::Remove(const std::shared_ptr<Disposable>& disposable)
+{
+    for (size_t i = 0; i < inlineCount; ++i)
+    {
+        if (inlineItems[i] != disposable) continue;
+
+        inlineItems[i] = std::move(inlineItems[--inlineCount]);
+        if (!overflow.empty())
+        {
+            inlineItems[inlineCount++] = std::move(overflow.back());
+            overflow.pop_back();
+        }
+        return true;
+    }
+
+    for (size_t i = 0; i < overflow.size(); ++i)
+    {
+        if (overflow[i] != disposable) continue;
+
+        overflow[i] = std::move(overflow.back());
+        overflow.pop_back();
+        return true;
+    }
+
+    return false;
+}
+
+void CompositeDisposable::Dispose()
+{
+    if (IsDisposed()) return;
+
+    Disposable::Dispose();
+
+    // 廃棄中の再入(Add/Remove)に影響されないよう、先に取り出してから廃棄する
+    std::shared_ptr<Disposable> items[InlineCapacity];
+    const auto count = inlineCount;
+    for (size_t i = 0; i < count; ++i)
+    {
+        items[i] = std::move(inlineItems[i]);
+    }
+    inlineCount = 0;
+    auto rest = std::move(overflow);
+    overflow.clear();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        items[i]->Dispose();
+    }
+    for (auto&& d : rest)
+    {
+        d->Dispose();
+    }
+}
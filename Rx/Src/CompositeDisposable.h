@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "Disposable.h"
+#include "RxPool.h"
+
+// 複数のDisposableをまとめて廃棄するDisposable
+// 数個程度ならオブジェクト内に持ち、溢れた分だけRxPoolから確保する
+// 廃棄済みのものは追加時にまとめて取り除くので、完了した購読が溜まり続けることはない
+// 注意: スレッドセーフではない
+class CompositeDisposable : public Disposable
+{
+    static constexpr size_t InlineCapacity = 4;
+
+    std::shared_ptr<Disposable> inlineItems[InlineCapacity];
+    size_t inlineCount = 0;
+    std::vector<std::shared_ptr<Disposable>, RxPool::Allocator<std::shared_ptr<Disposable>>> overflow;
+
+    void RemoveDisposed();
+
+public:
+    CompositeDisposable() = default;
+    ~CompositeDisposable() override = default;
+
+    CompositeDisposable(const CompositeDisposable&) = delete;
+    CompositeDisposable& operator=(const CompositeDisposable&) = delete;
+
+    // 既に廃棄済みの場合は追加せずにその場で廃棄する
+    void Add(std::shared_ptr<Disposable> disposable);
+
+    // 廃棄せずに取り除く
+    bool Remove(const std::shared_ptr<Disposable>& disposable);
+
+    size_t Count() const { return inlineCount + overflow.size(); }
+
+    // 保持している全てを1度の走査で廃棄する
+    void Dispose() override;
+};
@@ -0,0 +1,191 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "CompositeDisposable.h"
+#include "EpochReclaimer.h"
+#include "Observable.h"
+#include "Observer.h"
+#include "RxPool.h"
+
+// 複数スレッドからOnNext/Subscribe/Disposeできるサブジェクト
+// OnNextはロックを取らず、不変な登録物のスナップショットを読むだけ
+// Subscribe/Disposeはスナップショットを複製・差し替えし、古いものはEpochReclaimerで遅延解放する
+// 注意: 複数スレッドから同時にOnNextした場合、Observerも同時に呼ばれるため、登録する処理はスレッドセーフであること
+//       また、Dispose直後でも既に古いスナップショットを読んでいるOnNextからは呼ばれる可能性がある
+template <typename T>
+class ConcurrentSubject
+{
+    struct Source
+    {
+        ObserverPtr<T> observer;
+        const Disposable* disposer;
+    };
+
+    using Snapshot = std::vector<Source>;
+
+    struct Core
+    {
+        std::atomic<Snapshot*> snapshot;
+        std::mutex writeMutex;
+
+        Core(): snapshot(new Snapshot())
+        {
+        }
+
+        ~Core()
+        {
+            delete snapshot.load();
+        }
+
+        // 書き込み側: 現在のスナップショットを元に新しいものを作って差し替える
+        template <typename F>
+        void Update(F update)
+        {
+            Snapshot* old;
+            {
+                std::lock_guard<std::mutex> lock(writeMutex);
+                old = snapshot.load(std::memory_order_relaxed);
+                auto next = new Snapshot(*old);
+                update(*next);
+                snapshot.store(next);
+            }
+            EpochReclaimer::Instance().Retire(old);
+        }
+
+        void Remove(const Disposable* disposer)
+        {
+            Update([disposer](Snapshot& s)
+            {
+                for (auto itr = s.begin(); itr != s.end();)
+                {
+                    if (itr->disposer == disposer)
+                    {
+                        itr = s.erase(itr);
+                        continue;
+                    }
+                    ++itr;
+                }
+            });
+        }
+    };
+
+    struct Disposer : Disposable
+    {
+        std::weak_ptr<Core> core;
+
+        explicit Disposer(std::weak_ptr<Core> core): core(std::move(core))
+        {
+        }
+
+        void Dispose() override
+        {
+            if (IsDisposed()) return;
+
+            // 先に廃棄済みにしておくことで、並行するSubscribeが取り残した登録も確実に除かれる
+            Disposable::Dispose();
+
+            if (auto c = core.lock()) c->Remove(this);
+        }
+    };
+
+    // GetObservableからの購読全体をまとめて廃棄するDisposable (別スレッドからの購読と廃棄が重なってもよいようロックする)
+    struct Group : Disposable
+    {
+        std::mutex mutex;
+        CompositeDisposable items;
+
+        void Add(std::shared_ptr<Disposable> disposable)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            items.Add(std::move(disposable));
+        }
+
+        void Dispose() override
+        {
+            if (IsDisposed()) return;
+
+            Disposable::Dispose();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            items.Dispose();
+        }
+    };
+
+    std::shared_ptr<Core> core = RxPool::MakeShared<Core>();
+
+public:
+    void OnNext(const T& v)
+    {
+        auto guard = EpochReclaimer::Instance().Enter();
+        // Enterでのエポックの公開より後に読んだことが回収側から見えるよう、seq_cstで読む
+        // (acquireでは公開の前に読んだことになり得て、回収側が古いエポックを見たまま読んでいるスナップショットを解放し得る)
+        const auto snapshot = core->snapshot.load(std::memory_order_seq_cst);
+
+        for (auto&& e : *snapshot)
+        {
+            e.observer->OnNext(v);
+        }
+    }
+
+    void OnNextBatch(const T* data, size_t n)
+    {
+        auto guard = EpochReclaimer::Instance().Enter();
+        const auto snapshot = core->snapshot.load(std::memory_order_seq_cst);
+
+        for (auto&& e : *snapshot)
+        {
+            BatchSubscription::Scope batch(e.disposer);
+            e.observer->OnNextBatch(data, n);
+        }
+    }
+
+    void OnCompleted()
+    {
+        auto guard = EpochReclaimer::Instance().Enter();
+        const auto snapshot = core->snapshot.load(std::memory_order_seq_cst);
+
+        for (auto&& e : *snapshot)
+        {
+            e.observer->OnCompleted();
+        }
+    }
+
+    // 購読ごとに別のDisposableを返す (Take等で1つの購読が廃棄されても、同じObservableからの他の購読は残る)
+    std::shared_ptr<Observable<T>> GetObservable()
+    {
+        auto group = RxPool::MakeShared<Group>();
+        std::weak_ptr<Core> weakCore = core;
+
+        return RxPool::MakeShared<Observable<T>>(
+            [=](ObserverPtr<T> o) -> std::shared_ptr<Disposable>
+            {
+                auto disposer = RxPool::MakeShared<Disposer>(weakCore);
+                if (auto c = weakCore.lock())
+                {
+                    c->Update([&](Snapshot& s)
+                    {
+                        s.push_back(Source{std::move(o), disposer.get()});
+                    });
+
+                    // 全体が廃棄済みなら、追加と同時に廃棄される
+                    group->Add(disposer);
+
+                    // Subscribe中に別スレッドからDisposeされていた場合に取り残さない
+                    if (disposer->IsDisposed()) c->Remove(disposer.get());
+                }
+                return disposer;
+            },
+            group,
+            nullptr
+        );
+    }
+
+    size_t SubscriberCount() const
+    {
+        auto guard = EpochReclaimer::Instance().Enter();
+        return core->snapshot.load(std::memory_order_seq_cst)->size();
+    }
+};
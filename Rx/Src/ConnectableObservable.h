@@ -0,0 +1,145 @@
+#pragma once
+#include <memory>
+
+#include "CompositeDisposable.h"
+#include "Disposable.h"
+#include "Instrumentation.h"
+#include "Observable.h"
+#include "Observer.h"
+#include "RxPool.h"
+#include "Subject.h"
+
+// Subject.hから読み込まれた場合はまだ定義されていないので宣言しておく
+template <typename T>
+class Subject;
+
+// Connectで上流を1度だけ購読し、上流の値を内部のSubjectから全ての購読者へ流すObservable (Observable::Publishで作る)
+// 購読者がいくつあっても、上流のオペレータは1つの値につき1回だけ評価される
+// 注意: Subjectと同じくスレッドセーフではない
+template <typename T>
+class ConnectableObservable : public Observable<T>
+{
+    struct State : std::enable_shared_from_this<State>
+    {
+        std::shared_ptr<Observable<T>> source;
+        Subject<T> subject;
+        std::shared_ptr<Observable<T>> published; // Publish()から購読した場合の登録先
+        std::shared_ptr<Disposable> connection; // 上流の購読
+        size_t refCount = 0; // RefCountから購読中の数
+
+        bool IsConnected() const { return connection != nullptr && !connection->IsDisposed(); }
+
+        const std::shared_ptr<Disposable>& Connect()
+        {
+            if (IsConnected()) return connection;
+
+            // 接続中は上流から自身を生かしておく
+            auto self = this->shared_from_this();
+            connection = source->Subscribe(MakeObserver<Observer<T>>(
+                [self](const T& v) { self->subject.OnNext(v); },
+                [self] { self->subject.OnCompleted(); },
+                [self](const T* data, size_t n) { self->subject.OnNextBatch(data, n); }
+            ));
+            return connection;
+        }
+
+        void Disconnect()
+        {
+            if (connection == nullptr) return;
+
+            connection->Dispose();
+            connection = nullptr;
+        }
+    };
+
+    // RefCountから購読した1つ分 (廃棄すると参照数を減らし、0になったら上流から切断する)
+    // RefCountで作ったObservable経由で握られるので、循環しないよう状態は弱参照で持つ
+    struct RefCountSubscription : Disposable
+    {
+        std::weak_ptr<State> state;
+        std::shared_ptr<Disposable> inner;
+
+        void Dispose() override
+        {
+            if (IsDisposed()) return;
+
+            Disposable::Dispose();
+            inner->Dispose();
+
+            auto s = state.lock();
+            if (s != nullptr && --s->refCount == 0) s->Disconnect();
+        }
+    };
+
+    std::shared_ptr<State> state;
+
+    explicit ConnectableObservable(std::shared_ptr<State> state)
+        : Observable<T>(
+              [state](ObserverPtr<T> o) { return state->published->Subscribe(o); },
+              state->published->GetDisposable(),
+              std::static_pointer_cast<ObservableRef>(state->source)
+          ),
+          state(std::move(state))
+    {
+    }
+
+    static std::shared_ptr<State> MakeState(std::shared_ptr<Observable<T>> source)
+    {
+        auto s = RxPool::MakeShared<State>();
+        s->source = std::move(source);
+        s->published = s->subject.GetObservable();
+        return s;
+    }
+
+public:
+    explicit ConnectableObservable(std::shared_ptr<Observable<T>> source)
+        : ConnectableObservable(MakeState(std::move(source)))
+    {
+#if RX_INSTRUMENTATION
+        this->AttachNode(Instrumentation::MakeNode("Publish", state->source->GetNode()));
+#endif
+    }
+
+    // 上流を購読して値を流し始める。返り値を廃棄すると切断する (接続中に呼んだ場合は今の接続を返す)
+    std::shared_ptr<Disposable> Connect()
+    {
+        return state->Connect();
+    }
+
+    bool IsConnected() const { return state->IsConnected(); }
+
+    // 購読者がいる間だけ上流に接続するObservableを作る
+    // 最初の購読で接続し、全ての購読が廃棄されたら切断する
+    std::shared_ptr<Observable<T>> RefCount()
+    {
+        auto s = state;
+        // Publish()からの購読とは別にまとめて廃棄されるよう、登録先のObservableを分けておく
+        auto inner = s->subject.GetObservable();
+        // 作ったObservableからの購読全体 (これを廃棄した後に購読したものは、接続せずに廃棄済みのものを返す)
+        auto group = RxPool::MakeShared<CompositeDisposable>();
+
+        auto res = RxPool::MakeShared<Observable<T>>(
+            [s, inner, group](ObserverPtr<T> o) -> std::shared_ptr<Disposable>
+            {
+                if (group->IsDisposed())
+                {
+                    auto d = RxPool::MakeShared<Disposable>();
+                    d->Dispose();
+                    return d;
+                }
+
+                auto subscription = RxPool::MakeShared<RefCountSubscription>();
+                subscription->state = s;
+                subscription->inner = inner->Subscribe(o);
+                group->Add(subscription);
+
+                if (++s->refCount == 1) s->Connect();
+                return subscription;
+            },
+            group,
+            std::static_pointer_cast<ObservableRef>(this->shared_from_this())
+        );
+        res->AttachNode(this->GetNode());
+        return res;
+    }
+};
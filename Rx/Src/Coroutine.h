@@ -0,0 +1,271 @@
+#pragma once
+// C++20のコルーチンでフレーム待ちや最初の値待ちを書けるようにする (RX_COROUTINES=ONの時のみ有効)
+//
+//  Task DotDamage(std::shared_ptr<Observable<Enemy*>> enemy)
+//  {
+//      auto e = co_await enemy->FirstAsync();
+//      co_await Frames(3);
+//      e->Damage(15);
+//  }
+//
+// 注意: Subjectと同じくスレッドセーフではない。タスクはメインスレッドで動かすこと
+#if RX_COROUTINES
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "Disposable.h"
+#include "FrameTimerWheel.h"
+#include "Observable.h"
+#include "Observer.h"
+#include "RxPool.h"
+
+// タスクのコルーチンフレームを管理するDisposable
+// Disposeするとタスクを中断し、待機中の購読/タイマーごとフレームを破棄する (実行中なら次に中断した時点で破棄する)
+class TaskState : public Disposable
+{
+    std::coroutine_handle<> handle;
+    bool running = false;
+
+    void Destroy()
+    {
+        if (handle == nullptr) return;
+
+        // フレームの破棄で自身を握っているpromiseも消えるので生かしておく
+        auto self = shared_from_this();
+        auto h = handle;
+        handle = nullptr;
+        h.destroy();
+    }
+
+public:
+    explicit TaskState(std::coroutine_handle<> handle): handle(handle)
+    {
+    }
+
+    void Dispose() override
+    {
+        if (IsDisposed()) return;
+
+        Disposable::Dispose();
+        if (!running) Destroy();
+    }
+
+    // 中断中のタスクを再開する (廃棄済みなら再開せずに破棄する)
+    void Resume()
+    {
+        if (handle == nullptr) return;
+        if (IsDisposed())
+        {
+            Destroy();
+            return;
+        }
+
+        auto self = shared_from_this();
+        running = true;
+        handle.resume();
+        running = false;
+
+        // 実行中にDisposeされた場合はここで破棄する
+        if (IsDisposed()) Destroy();
+    }
+
+    // 最後まで実行したか、中断(Dispose)されてフレームが破棄済み
+    bool IsDone() const { return handle == nullptr; }
+
+    // promiseの破棄時に呼ばれる
+    void Detach() { handle = nullptr; }
+};
+
+// co_awaitを使える戻り値型。呼び出すと最初のco_awaitまでその場で実行される
+// 戻り値を捨てても最後まで実行される。途中で止めたい場合はGetDisposable()をDisposeする(AddToで寿命に紐づけても良い)
+class Task
+{
+    std::shared_ptr<TaskState> state;
+
+public:
+    class promise_type
+    {
+        std::shared_ptr<TaskState> state;
+
+        // 初回の実行もTaskState::Resumeを通し、実行中のDisposeを扱えるようにする
+        struct Starter
+        {
+            bool await_ready() const noexcept { return false; }
+
+            void await_suspend(std::coroutine_handle<promise_type> h) const
+            {
+                // Resume中にフレームごと破棄され得るので、メンバではなくローカルに持っておく
+                auto s = h.promise().state;
+                s->Resume();
+            }
+
+            void await_resume() const noexcept
+            {
+            }
+        };
+
+    public:
+        promise_type()
+            : state(RxPool::MakeShared<TaskState>(std::coroutine_handle<promise_type>::from_promise(*this)))
+        {
+        }
+
+        ~promise_type() { state->Detach(); }
+
+        // コルーチンフレームもプールから確保する
+        static void* operator new(size_t size) { return RxPool::Allocate(size); }
+        static void operator delete(void* p, size_t size) noexcept { RxPool::Deallocate(p, size); }
+
+        const std::shared_ptr<TaskState>& State() const { return state; }
+
+        Task get_return_object() { return Task(state); }
+        Starter initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+
+        void return_void()
+        {
+        }
+
+        // 例外は扱わない (Observer側と同じく、投げた時点で終了させる)
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    explicit Task(std::shared_ptr<TaskState> state): state(std::move(state))
+    {
+    }
+
+    const std::shared_ptr<TaskState>& GetDisposable() const { return state; }
+    bool IsDone() const { return state->IsDone(); }
+};
+
+// 指定フレーム数(DoEveryUpdateの呼び出し回数)だけ待つ。待っている間はFrameTimerWheelに登録されるだけで毎フレームのコストはかからない
+class FrameAwaiter
+{
+    uint32_t frames;
+    std::shared_ptr<FrameTimerWheel::Timer> timer;
+
+public:
+    explicit FrameAwaiter(uint32_t frames): frames(frames)
+    {
+    }
+
+    FrameAwaiter(const FrameAwaiter&) = delete;
+    FrameAwaiter& operator=(const FrameAwaiter&) = delete;
+
+    // 待機中にタスクが破棄された場合はタイマーも止める
+    ~FrameAwaiter()
+    {
+        if (timer != nullptr) timer->Dispose();
+    }
+
+    bool await_ready() const noexcept { return frames == 0; }
+
+    void await_suspend(std::coroutine_handle<Task::promise_type> h)
+    {
+        std::weak_ptr<TaskState> weak = h.promise().State();
+        timer = FrameTimerWheel::Main().Schedule(frames, [weak]
+        {
+            if (auto s = weak.lock()) s->Resume();
+        });
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+};
+
+// numフレーム待つ (0以下なら待たない)
+inline FrameAwaiter Frames(int num)
+{
+    return FrameAwaiter(num > 0 ? static_cast<uint32_t>(num) : 0);
+}
+
+// 次のフレームまで待つ
+inline FrameAwaiter NextFrame()
+{
+    return FrameAwaiter(1);
+}
+
+// Observable::FirstAsyncが返す、最初の値を待つAwaiter
+// 値を受け取ったら購読を廃棄する。値が来ないまま完了した場合はタスクを中断(Dispose)する
+// 廃棄するのはこの購読だけなので、同じObservableを複数のタスクで同時に待ってもよい
+template <typename T>
+class FirstAsyncAwaiter
+{
+    // Observerからthisを参照しないよう、受け取った値と待機中のタスクは別に持つ
+    struct Slot
+    {
+        std::optional<T> value;
+        std::weak_ptr<TaskState> task;
+        bool completed = false;
+    };
+
+    std::shared_ptr<const Observable<T>> source;
+    std::shared_ptr<Slot> slot;
+    std::shared_ptr<Disposable> subscription;
+
+public:
+    explicit FirstAsyncAwaiter(std::shared_ptr<const Observable<T>> source): source(std::move(source))
+    {
+    }
+
+    FirstAsyncAwaiter(const FirstAsyncAwaiter&) = delete;
+    FirstAsyncAwaiter& operator=(const FirstAsyncAwaiter&) = delete;
+
+    ~FirstAsyncAwaiter()
+    {
+        if (subscription != nullptr) subscription->Dispose();
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    bool await_suspend(std::coroutine_handle<Task::promise_type> h)
+    {
+        slot = RxPool::MakeShared<Slot>();
+
+        auto s = slot;
+        subscription = source->Subscribe(MakeObserver<Observer<T>>(
+            [s](const T& v)
+            {
+                if (s->value.has_value() || s->completed) return;
+
+                s->value.emplace(v);
+                if (auto task = s->task.lock()) task->Resume();
+            },
+            [s]
+            {
+                if (s->value.has_value() || s->completed) return;
+
+                s->completed = true;
+                if (auto task = s->task.lock()) task->Dispose();
+            }
+        ));
+
+        // 購読時に値が流れてきた場合は中断せずにそのまま続ける
+        if (s->value.has_value()) return false;
+
+        // 値が無いまま完了済み。中断した後にTaskState::Resumeが破棄する
+        if (s->completed)
+        {
+            h.promise().State()->Dispose();
+            return true;
+        }
+
+        s->task = h.promise().State();
+        return true;
+    }
+
+    T await_resume() { return std::move(*slot->value); }
+};
+
+template <typename T>
+FirstAsyncAwaiter<T> Observable<T>::FirstAsync() const
+{
+    return FirstAsyncAwaiter<T>(this->shared_from_this());
+}
+#endif
@@ -7,7 +7,7 @@ Disposable::Disposable(): isDisposed(false)
 
 void Disposable::Dispose()
 {
-    isDisposed = true;
+    isDisposed.store(true, std::memory_order_release);
 }
 
 std::shared_ptr<Disposable> Disposable::AddTo(ObservableDestroyTrigger* obj)
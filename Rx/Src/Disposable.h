@@ -1,18 +1,19 @@
 ﻿#pragma once
+#include <atomic>
 #include <memory>
 
 class ObservableDestroyTrigger;
 
 class Disposable : public std::enable_shared_from_this<Disposable>
 {
-    bool isDisposed;
+    std::atomic<bool> isDisposed; // ConcurrentSubject等で別スレッドからDisposeされる場合がある
 
 public:
     Disposable();
     virtual ~Disposable() = default;
 
     virtual void Dispose();
-    bool IsDisposed() const { return isDisposed; }
+    bool IsDisposed() const { return isDisposed.load(std::memory_order_acquire); }
     std::shared_ptr<Disposable> AddTo(ObservableDestroyTrigger* obj);
     std::shared_ptr<Disposable> AddTo(std::weak_ptr<ObservableDestroyTrigger> obj);
 };
@@ -0,0 +1,124 @@
+#include "EpochReclaimer.h"
+
+#include <stdexcept>
+
+// スレッドごとのスロット割り当てと入れ子の深さ
+struct EpochThreadRecord
+{
+    EpochReclaimer* reclaimer = nullptr;
+    size_t slot = 0;
+    int depth = 0;
+
+    ~EpochThreadRecord()
+    {
+        if (reclaimer != nullptr) reclaimer->ReleaseSlot(slot);
+    }
+};
+
+static thread_local EpochThreadRecord threadRecord;
+
+EpochReclaimer::~EpochReclaimer()
+{
+    for (auto&& e : retired)
+    {
+        e.deleter(e.ptr);
+    }
+}
+
+EpochReclaimer& EpochReclaimer::Instance()
+{
+    static EpochReclaimer instance;
+    return instance;
+}
+
+size_t EpochReclaimer::AcquireSlot()
+{
+    for (size_t i = 0; i < MaxThreads; ++i)
+    {
+        auto expected = false;
+        if (slots[i].used.compare_exchange_strong(expected, true)) return i;
+    }
+
+    throw std::runtime_error("EpochReclaimer: too many threads");
+}
+
+void EpochReclaimer::ReleaseSlot(size_t slot)
+{
+    slots[slot].epoch.store(0);
+    slots[slot].used.store(false);
+}
+
+EpochReclaimer::ReaderSlot& EpochReclaimer::CurrentSlot()
+{
+    if (threadRecord.reclaimer == nullptr)
+    {
+        threadRecord.slot = AcquireSlot();
+        threadRecord.reclaimer = this;
+    }
+    return slots[threadRecord.slot];
+}
+
+EpochReclaimer::Guard EpochReclaimer::Enter()
+{
+    auto& slot = CurrentSlot();
+    if (threadRecord.depth++ == 0)
+    {
+        // 以降の読み込みより前に自身のエポックが見えるよう、seq_cstで公開する (保護する読み込みもseq_cstで行うこと)
+        slot.epoch.store(globalEpoch.load());
+    }
+    return Guard(this);
+}
+
+void EpochReclaimer::Exit()
+{
+    if (--threadRecord.depth == 0)
+    {
+        slots[threadRecord.slot].epoch.store(0, std::memory_order_release);
+    }
+}
+
+uint64_t EpochReclaimer::MinActiveEpoch() const
+{
+    auto min = UINT64_MAX;
+    for (auto&& slot : slots)
+    {
+        const auto e = slot.epoch.load();
+        if (e != 0 && e < min) min = e;
+    }
+    return min;
+}
+
+void EpochReclaimer::Retire(void* ptr, void (*deleter)(void*))
+{
+    {
+        std::lock_guard<std::mutex> lock(retireMutex);
+        // 差し替え前のデータを見ている可能性があるのは、このエポック以前に入った読み取り側のみ
+        retired.push_back(Retired{globalEpoch.fetch_add(1), ptr, deleter});
+    }
+    Collect();
+}
+
+void EpochReclaimer::Collect()
+{
+    std::vector<Retired> reclaimable;
+    {
+        std::lock_guard<std::mutex> lock(retireMutex);
+        const auto min = MinActiveEpoch();
+        for (auto itr = retired.begin(); itr != retired.end();)
+        {
+            if (itr->epoch < min)
+            {
+                reclaimable.emplace_back(*itr);
+                itr = retired.erase(itr);
+                continue;
+            }
+            ++itr;
+        }
+    }
+
+    // 解放処理(Observerのデストラクタ等)はロック外で行う
+    for (auto&& e : reclaimable)
+    {
+        e.deleter(e.ptr);
+    }
+}
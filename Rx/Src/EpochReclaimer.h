@@ -0,0 +1,88 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// エポックベースの遅延解放 (RCU的な読み取り側ロックフリー参照のためのもの)
+// 読み取り側はGuardの生存中に取得したポインタを安全に参照でき、
+// 書き込み側はRetireした古いデータを、全読み取り側がそのエポックを抜けた後に解放する
+class EpochReclaimer
+{
+public:
+    static constexpr size_t MaxThreads = 128;
+
+    class Guard
+    {
+        EpochReclaimer* reclaimer;
+
+    public:
+        explicit Guard(EpochReclaimer* reclaimer): reclaimer(reclaimer)
+        {
+        }
+
+        Guard(Guard&& other) noexcept: reclaimer(other.reclaimer) { other.reclaimer = nullptr; }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        Guard& operator=(Guard&&) = delete;
+
+        ~Guard()
+        {
+            if (reclaimer != nullptr) reclaimer->Exit();
+        }
+    };
+
+private:
+    // 偽共有を避けるためスレッドごとにキャッシュラインを分ける
+    struct alignas(64) ReaderSlot
+    {
+        std::atomic<uint64_t> epoch{0}; // 0は読み取り区間外
+        std::atomic<bool> used{false};
+    };
+
+    struct Retired
+    {
+        uint64_t epoch;
+        void* ptr;
+        void (*deleter)(void*);
+    };
+
+    std::atomic<uint64_t> globalEpoch{1};
+    ReaderSlot slots[MaxThreads];
+
+    std::mutex retireMutex;
+    std::vector<Retired> retired;
+
+    size_t AcquireSlot();
+    void ReleaseSlot(size_t slot);
+    ReaderSlot& CurrentSlot();
+    void Exit();
+    uint64_t MinActiveEpoch() const;
+
+    friend struct EpochThreadRecord;
+
+public:
+    EpochReclaimer() = default;
+    ~EpochReclaimer();
+
+    EpochReclaimer(const EpochReclaimer&) = delete;
+    EpochReclaimer& operator=(const EpochReclaimer&) = delete;
+
+    static EpochReclaimer& Instance();
+
+    // 読み取り区間に入る (入れ子可)。区間内で保護するポインタはseq_cstで読むこと
+    Guard Enter();
+
+    // 古いデータの解放を予約する。既に誰も参照していなければその場で解放される
+    void Retire(void* ptr, void (*deleter)(void*));
+
+    template <typename U>
+    void Retire(U* ptr)
+    {
+        Retire(ptr, [](void* p) { delete static_cast<U*>(p); });
+    }
+
+    // 解放可能になったものを解放
+    void Collect();
+};
@@ -0,0 +1,138 @@
+#include "EventLog.h"
+
+#include <stdexcept>
+
+namespace
+{
+    constexpr char Magic[4] = {'R', 'X', 'E', 'V'};
+    constexpr size_t HeaderSize = EventLogHeaderSize;
+    static_assert(HeaderSize == sizeof(Magic) + sizeof(uint32_t) * 3, "event log header layout");
+}
+
+EventLogWriter::EventLogWriter(const std::string& path, uint32_t valueSize)
+    : valueSize(valueSize),
+      start(std::chrono::steady_clock::now())
+{
+    file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) throw std::runtime_error("EventLogWriter: cannot open " + path);
+
+    unsigned char header[HeaderSize] = {};
+    std::memcpy(header, Magic, sizeof(Magic));
+    std::memcpy(header + sizeof(Magic), &EventLogVersion, sizeof(uint32_t));
+    std::memcpy(header + sizeof(Magic) + sizeof(uint32_t), &valueSize, sizeof(uint32_t));
+    std::fwrite(header, 1, sizeof(header), file);
+
+    buffer.reserve(FlushThreshold);
+    writing.reserve(FlushThreshold);
+    thread = std::thread([this] { Run(); });
+}
+
+EventLogWriter::~EventLogWriter()
+{
+    Close();
+}
+
+void EventLogWriter::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        condition.wait(lock, [this] { return closing || flushRequested || buffer.size() >= FlushThreshold; });
+
+        // 積まれていたものを受け取り、ロックを離して書き出す
+        writing.swap(buffer);
+        flushRequested = false;
+        const auto done = closing;
+
+        lock.unlock();
+        if (!writing.empty()) std::fwrite(writing.data(), 1, writing.size(), file);
+        writing.clear();
+        lock.lock();
+
+        if (done) break;
+    }
+}
+
+void EventLogWriter::Append(uint64_t frame, const void* values, size_t n)
+{
+    const auto timeNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+
+    bool notify;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closing) return;
+
+        const auto recordSize = sizeof(uint64_t) * 2 + valueSize;
+        const auto offset = buffer.size();
+        buffer.resize(offset + recordSize * n);
+
+        auto* out = buffer.data() + offset;
+        const auto* v = static_cast<const unsigned char*>(values);
+        for (size_t i = 0; i < n; ++i)
+        {
+            std::memcpy(out, &frame, sizeof(uint64_t));
+            std::memcpy(out + sizeof(uint64_t), &timeNs, sizeof(uint64_t));
+            std::memcpy(out + sizeof(uint64_t) * 2, v + i * valueSize, valueSize);
+            out += recordSize;
+        }
+        // 閾値を超えた時だけ起こす
+        notify = offset < FlushThreshold && buffer.size() >= FlushThreshold;
+    }
+    if (notify) condition.notify_one();
+}
+
+void EventLogWriter::Flush()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        flushRequested = true;
+    }
+    condition.notify_one();
+}
+
+void EventLogWriter::Close()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (closing) return;
+
+        closing = true;
+    }
+    condition.notify_one();
+
+    thread.join();
+    std::fclose(file);
+    file = nullptr;
+}
+
+std::vector<unsigned char> ReadEventLogRecords(const std::string& path, uint32_t valueSize)
+{
+    auto file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) throw std::runtime_error("ReadEventLog: cannot open " + path);
+
+    std::vector<unsigned char> data;
+    unsigned char chunk[64 * 1024];
+    size_t read;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+    {
+        data.insert(data.end(), chunk, chunk + read);
+    }
+    std::fclose(file);
+
+    uint32_t version = 0;
+    uint32_t size = 0;
+    if (data.size() < HeaderSize || std::memcmp(data.data(), Magic, sizeof(Magic)) != 0)
+    {
+        throw std::runtime_error("ReadEventLog: not an event log " + path);
+    }
+    std::memcpy(&version, data.data() + sizeof(Magic), sizeof(uint32_t));
+    std::memcpy(&size, data.data() + sizeof(Magic) + sizeof(uint32_t), sizeof(uint32_t));
+    if (version != EventLogVersion) throw std::runtime_error("ReadEventLog: unsupported version " + path);
+    if (size != valueSize) throw std::runtime_error("ReadEventLog: value size mismatch " + path);
+
+    // 書き出し途中で終わった末尾のレコードは捨てる
+    const auto recordSize = sizeof(uint64_t) * 2 + valueSize;
+    const auto count = (data.size() - HeaderSize) / recordSize;
+    return std::vector<unsigned char>(data.begin() + HeaderSize, data.begin() + HeaderSize + count * recordSize);
+}
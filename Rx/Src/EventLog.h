@@ -0,0 +1,201 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "Disposable.h"
+#include "FrameTimerWheel.h"
+#include "RxPool.h"
+
+// Replayの流し先 (Observable.hから読み込まれるので、Subject.hは読み込まずに宣言だけしておく)
+template <typename T>
+class Subject;
+
+// 流れた値をフレーム番号と時刻付きでバイナリのログに記録し、後から同じ順序で流し直す (負荷の再現用)
+//
+// 形式 (ネイティブのバイト順。同じ環境で読み書きすること):
+//   ヘッダ  "RXEV" | バージョン(uint32) | 値のサイズ(uint32) | 予約(uint32, 0)
+//   レコード フレーム番号(uint64) | 記録開始からの経過時間ns(uint64) | 値(値のサイズ分)
+// 値はtrivially copyableな型のみ (そのままのバイト列で保存する。既定コンストラクタは無くても良い)
+// ヘッダを16バイトにしてレコードを8バイト境界から始めるので、sizeof(EventRecord<T>)が16 + sizeof(T)の型なら
+// ObservableUtil::FromMappedFile<EventRecord<T>>(path, EventLogHeaderSize)でコピーせずに読める
+
+constexpr uint32_t EventLogVersion = 1;
+constexpr size_t EventLogHeaderSize = 16;
+
+// バックグラウンドのスレッドでファイルへ書き出すライター
+// Appendはバッファに積むだけで、溜まったらライタースレッドへ渡してまとめて書き出す (書き出しが遅れる間はバッファが伸びる)
+class EventLogWriter
+{
+    std::FILE* file = nullptr;
+    uint32_t valueSize;
+    std::chrono::steady_clock::time_point start;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<unsigned char> buffer; // 積んでいるもの
+    std::vector<unsigned char> writing; // ライタースレッドが書き出し中のもの (確保した領域を使い回す)
+    bool flushRequested = false;
+    bool closing = false;
+    std::thread thread;
+
+    void Run();
+
+public:
+    // これだけ溜まったらライタースレッドへ渡す
+    static constexpr size_t FlushThreshold = 64 * 1024;
+
+    // ファイルを開けなかった場合はstd::runtime_errorを投げる
+    EventLogWriter(const std::string& path, uint32_t valueSize);
+    ~EventLogWriter();
+
+    EventLogWriter(const EventLogWriter&) = delete;
+    EventLogWriter& operator=(const EventLogWriter&) = delete;
+
+    // n個の値を同じフレーム/時刻で積む (閉じた後は何もしない)
+    void Append(uint64_t frame, const void* values, size_t n);
+
+    // 積んでいるものを書き出すよう促す (書き出しの完了は待たない)
+    void Flush();
+
+    // 全て書き出してファイルを閉じる
+    void Close();
+
+    uint32_t ValueSize() const { return valueSize; }
+};
+
+// ログのレコードをそのままのバイト列で読み込む。開けない/壊れている/値のサイズが違う場合はstd::runtime_errorを投げる
+std::vector<unsigned char> ReadEventLogRecords(const std::string& path, uint32_t valueSize);
+
+namespace EventLogDetail
+{
+    // レコードの位置から値を取り出す (既定コンストラクタの無い型も扱えるよう、揃えた領域へコピーしてから値をコピーする)
+    template <typename T>
+    T LoadValue(const unsigned char* p)
+    {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+        std::memcpy(&storage, p, sizeof(T));
+        return *reinterpret_cast<const T*>(&storage);
+    }
+
+    inline uint64_t LoadUInt64(const unsigned char* p)
+    {
+        uint64_t v;
+        std::memcpy(&v, p, sizeof(uint64_t));
+        return v;
+    }
+}
+
+template <typename T>
+struct EventRecord
+{
+    uint64_t frame;
+    uint64_t timeNs;
+    T value;
+};
+
+// ログを読み込む
+template <typename T>
+std::vector<EventRecord<T>> ReadEventLog(const std::string& path)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "event log values must be trivially copyable");
+
+    const auto raw = ReadEventLogRecords(path, sizeof(T));
+    const auto recordSize = sizeof(uint64_t) * 2 + sizeof(T);
+
+    const auto count = raw.size() / recordSize;
+
+    std::vector<EventRecord<T>> records;
+    records.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto* p = raw.data() + i * recordSize;
+        records.push_back(EventRecord<T>{EventLogDetail::LoadUInt64(p),
+                                         EventLogDetail::LoadUInt64(p + sizeof(uint64_t)),
+                                         EventLogDetail::LoadValue<T>(p + sizeof(uint64_t) * 2)});
+    }
+    return records;
+}
+
+enum class ReplayMode
+{
+    AsFastAsPossible, // その場で全て流す
+    FramePaced, // 記録時のフレームの間隔を保って、ObservableUtil::DoEveryUpdateのフレームに合わせて流す
+};
+
+// ログの値をsubjectへ流し直す。同じフレームに記録された値はまとめて(OnNextBatchで)流す
+// FramePacedの場合、最初のレコードのフレームを次のフレームに合わせ、以降は記録時と同じフレーム間隔で流す
+// 返り値をDisposeすると途中で止まる。流し終えてもsubjectは完了させない
+template <typename T>
+std::shared_ptr<Disposable> Replay(const std::string& path, std::shared_ptr<Subject<T>> subject, ReplayMode mode)
+{
+    // 同じフレームの値を連続した配列として流せるよう、値とフレームを分けて持つ
+    struct Log
+    {
+        std::vector<T> values;
+        std::vector<uint64_t> frames;
+        size_t next = 0;
+        uint64_t elapsed = 0; // FramePacedで流し始めてからのフレーム数
+        std::weak_ptr<FrameTimerWheel::Timer> timer;
+
+        // frameまでに記録された値を流す
+        void EmitUntil(Subject<T>& s, uint64_t frame)
+        {
+            while (next < values.size() && frames[next] <= frame)
+            {
+                auto end = next + 1;
+                while (end < values.size() && frames[end] == frames[next]) ++end;
+
+                s.OnNextBatch(values.data() + next, end - next);
+                next = end;
+            }
+        }
+    };
+
+    static_assert(std::is_trivially_copyable<T>::value, "event log values must be trivially copyable");
+
+    const auto raw = ReadEventLogRecords(path, sizeof(T));
+    const auto recordSize = sizeof(uint64_t) * 2 + sizeof(T);
+    const auto count = raw.size() / recordSize;
+
+    auto log = RxPool::MakeShared<Log>();
+    log->values.reserve(count);
+    log->frames.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto* p = raw.data() + i * recordSize;
+        log->frames.push_back(EventLogDetail::LoadUInt64(p));
+        log->values.push_back(EventLogDetail::LoadValue<T>(p + sizeof(uint64_t) * 2));
+    }
+
+    if (mode == ReplayMode::AsFastAsPossible || log->values.empty())
+    {
+        if (!log->values.empty()) log->EmitUntil(*subject, log->frames.back());
+
+        auto done = RxPool::MakeShared<Disposable>();
+        done->Dispose();
+        return done;
+    }
+
+    // フレームごとに、記録開始からの経過フレームまでに記録された値を流す
+    const auto first = log->frames.front();
+    auto timer = FrameTimerWheel::Main().Schedule(1, [log, subject, first]
+    {
+        log->EmitUntil(*subject, first + log->elapsed++);
+        if (log->next < log->values.size()) return;
+
+        // 流し終えたら止める
+        if (auto t = log->timer.lock()) t->Dispose();
+    }, 1);
+    log->timer = timer;
+    return timer;
+}
@@ -0,0 +1,187 @@
+#include "FrameTimerWheel.h"
+
+#include "RxPool.h"
+
+void FrameTimerWheel::Timer::Dispose()
+{
+    if (IsDisposed()) return;
+
+    Disposable::Dispose();
+
+    if (pprev != nullptr)
+    {
+        Unlink(this);
+        --wheel->count;
+    }
+
+    // 最後の参照だった場合はここで破棄されるので、以降メンバに触らない
+    auto keep = std::move(self);
+}
+
+FrameTimerWheel::~FrameTimerWheel()
+{
+    Clear();
+}
+
+void FrameTimerWheel::Clear()
+{
+    const auto release = [this](Timer*& head)
+    {
+        while (auto timer = head)
+        {
+            Unlink(timer);
+            --count;
+            auto keep = std::move(timer->self);
+        }
+    };
+
+    for (auto&& head : root)
+    {
+        release(head);
+    }
+    for (auto&& level : levels)
+    {
+        for (auto&& head : level)
+        {
+            release(head);
+        }
+    }
+}
+
+FrameTimerWheel& FrameTimerWheel::Main()
+{
+    static FrameTimerWheel instance;
+    return instance;
+}
+
+void FrameTimerWheel::Link(Timer*& head, Timer* timer)
+{
+    timer->next = head;
+    if (head != nullptr) head->pprev = &timer->next;
+    head = timer;
+    timer->pprev = &head;
+}
+
+void FrameTimerWheel::Unlink(Timer* timer)
+{
+    *timer->pprev = timer->next;
+    if (timer->next != nullptr) timer->next->pprev = timer->pprev;
+    timer->next = nullptr;
+    timer->pprev = nullptr;
+}
+
+void FrameTimerWheel::Add(Timer* timer)
+{
+    // 次に処理するフレームからの距離で入れる段を決める
+    const auto nextFrame = frame + 1;
+    auto expire = timer->expire;
+    auto delta = expire - nextFrame;
+
+    if (delta < RootSize)
+    {
+        Link(root[expire & (RootSize - 1)], timer);
+        return;
+    }
+
+    // 上位の段でも収まらないほど先のものは、一番遠いスロットに入れておき、下ろされた時に入れ直す
+    if (delta > MaxDelta)
+    {
+        delta = MaxDelta;
+        expire = nextFrame + delta;
+    }
+
+    for (int level = 0; level < LevelCount; ++level)
+    {
+        const auto shift = RootBits + LevelBits * level;
+        if (delta < (1ull << (shift + LevelBits)))
+        {
+            Link(levels[level][(expire >> shift) & (LevelSize - 1)], timer);
+            return;
+        }
+    }
+}
+
+uint32_t FrameTimerWheel::Cascade(int level, uint64_t nextFrame)
+{
+    const auto index = static_cast<uint32_t>((nextFrame >> (RootBits + LevelBits * level)) & (LevelSize - 1));
+
+    // スロットを丸ごと取り外してから入れ直す
+    Timer* list = levels[level][index];
+    levels[level][index] = nullptr;
+    if (list != nullptr) list->pprev = &list;
+
+    while (auto timer = list)
+    {
+        Unlink(timer);
+        Add(timer);
+    }
+
+    return index;
+}
+
+std::shared_ptr<FrameTimerWheel::Timer> FrameTimerWheel::Schedule(uint32_t delay, Function<void()> callback,
+                                                                  uint32_t period)
+{
+    auto timer = RxPool::MakeShared<Timer>();
+    timer->wheel = this;
+    timer->expire = frame + (delay > 0 ? delay : 1);
+    timer->period = period;
+    timer->callback = std::move(callback);
+    timer->self = timer;
+
+    Add(timer.get());
+    ++count;
+    return timer;
+}
+
+void FrameTimerWheel::Advance()
+{
+    const auto nextFrame = frame + 1;
+    const auto index = static_cast<uint32_t>(nextFrame & (RootSize - 1));
+
+    // 1段目が一周したら上位の段から次の範囲を下ろしてくる
+    if (index == 0)
+    {
+        for (int level = 0; level < LevelCount; ++level)
+        {
+            if (Cascade(level, nextFrame) != 0) break;
+        }
+    }
+
+    frame = nextFrame;
+
+    // 発火するものを取り外してから実行する (実行中の登録・解除に影響されないように)
+    Timer* list = root[index];
+    root[index] = nullptr;
+    if (list != nullptr) list->pprev = &list;
+
+    while (auto timer = list)
+    {
+        Unlink(timer);
+
+        // 上位の段に入れておいた遠すぎるものは入れ直す
+        if (timer->expire != frame)
+        {
+            Add(timer);
+            continue;
+        }
+
+        auto keep = timer->self;
+        if (timer->period > 0)
+        {
+            // 実行前に次回分を登録しておく (実行中にDisposeされた場合はそこで外れる)
+            timer->expire = frame + timer->period;
+            Add(timer);
+        }
+        else
+        {
+            --count;
+            timer->self = nullptr;
+        }
+
+        timer->callback();
+
+        // 1回きりのものは実行後に廃棄済みにする
+        if (timer->period == 0) timer->Disposable::Dispose();
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Disposable.h"
+#include "Function.h"
+
+// フレーム数で指定するタイマーを管理する階層型タイマーホイール
+// Advance()1回が1フレームで、そのフレームに発火するタイマーの分だけ処理する (登録数には比例しない)
+// 直近256フレーム以内のものは1段目に、それ以降のものは粒度の粗い上位の段に入れておき、
+// 1段目が一周するたびに上位の段から1スロット分を下ろしてくる
+class FrameTimerWheel
+{
+public:
+    // 登録したタイマー (Disposeで登録解除)
+    class Timer : public Disposable
+    {
+        friend class FrameTimerWheel;
+
+        FrameTimerWheel* wheel = nullptr;
+        uint64_t expire = 0;
+        uint32_t period = 0; // 0なら1回きり
+        Function<void()> callback;
+
+        // 連結リスト (pprevは前の要素のnext、またはスロットの先頭を指す)
+        Timer* next = nullptr;
+        Timer** pprev = nullptr;
+
+        std::shared_ptr<Timer> self; // ホイールに登録中は自身を生かしておく
+
+    public:
+        void Dispose() override;
+    };
+
+private:
+    static constexpr int RootBits = 8;
+    static constexpr int LevelBits = 6;
+    static constexpr int LevelCount = 3; // 1段目より上の段の数
+    static constexpr uint32_t RootSize = 1u << RootBits;
+    static constexpr uint32_t LevelSize = 1u << LevelBits;
+    static constexpr uint64_t MaxDelta = (1ull << (RootBits + LevelBits * LevelCount)) - 1;
+
+    Timer* root[RootSize] = {};
+    Timer* levels[LevelCount][LevelSize] = {};
+
+    uint64_t frame = 0; // 処理済みのフレーム数
+    size_t count = 0;
+
+    static void Link(Timer*& head, Timer* timer);
+    static void Unlink(Timer* timer);
+
+    void Add(Timer* timer);
+    uint32_t Cascade(int level, uint64_t nextFrame);
+
+public:
+    FrameTimerWheel() = default;
+    ~FrameTimerWheel();
+
+    FrameTimerWheel(const FrameTimerWheel&) = delete;
+    FrameTimerWheel& operator=(const FrameTimerWheel&) = delete;
+
+    // ObservableUtil::DoEveryUpdate()で進められるホイール
+    static FrameTimerWheel& Main();
+
+    // delayフレーム後(1以上)のAdvanceで発火する。periodを指定すると以降periodフレームごとに発火する
+    std::shared_ptr<Timer> Schedule(uint32_t delay, Function<void()> callback, uint32_t period = 0);
+
+    // 1フレーム進めて、このフレームに発火するタイマーを実行する
+    void Advance();
+
+    // 登録中のタイマーを全て破棄する (発火はしない)
+    void Clear();
+
+    uint64_t Frame() const { return frame; }
+    size_t Count() const { return count; }
+};
@@ -0,0 +1,200 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "RxPool.h"
+
+// Functionの中に直接置ける処理の大きさ (CMakeのRX_FUNCTION_INLINE_SIZEで変更できる)
+#ifndef RX_FUNCTION_INLINE_SIZE
+#define RX_FUNCTION_INLINE_SIZE 16
+#endif
+
+constexpr size_t FunctionInlineSize = RX_FUNCTION_INLINE_SIZE;
+
+// std::functionの代わりに使う型消去された呼び出し可能オブジェクト
+// FunctionInlineSize以下でムーブが例外を投げない処理は内部に直接置き、それより大きいものはRxPoolから確保する
+// (どちらの場合も購読の組み立て/廃棄で大域アロケータを呼ばず、ムーブでは確保しない)
+template <typename Sig>
+class Function;
+
+template <typename R, typename... Args>
+class Function<R(Args...)>
+{
+    union Storage
+    {
+        void* heap;
+        alignas(void*) unsigned char buffer[FunctionInlineSize];
+    };
+
+    struct Ops
+    {
+        R (*invoke)(Storage&, Args...);
+        void (*copy)(const Storage&, Storage&);
+        void (*move)(Storage&, Storage&); // 移動元は破棄済みになる
+        void (*destroy)(Storage&);
+    };
+
+    template <typename F>
+    struct IsInline : std::integral_constant<bool, sizeof(F) <= FunctionInlineSize &&
+                                                   alignof(F) <= alignof(void*) &&
+                                                   std::is_nothrow_move_constructible<F>::value>
+    {
+    };
+
+    template <typename F>
+    static F* Get(Storage& s, std::true_type) { return reinterpret_cast<F*>(s.buffer); }
+
+    template <typename F>
+    static F* Get(Storage& s, std::false_type) { return static_cast<F*>(s.heap); }
+
+    template <typename F>
+    static const F* Get(const Storage& s, std::true_type) { return reinterpret_cast<const F*>(s.buffer); }
+
+    template <typename F>
+    static const F* Get(const Storage& s, std::false_type) { return static_cast<const F*>(s.heap); }
+
+    template <typename F, typename... A>
+    static void Construct(Storage& s, std::true_type, A&&... a) { new(s.buffer) F(std::forward<A>(a)...); }
+
+    template <typename F, typename... A>
+    static void Construct(Storage& s, std::false_type, A&&... a) { s.heap = RxPool::New<F>(std::forward<A>(a)...); }
+
+    template <typename F>
+    static void Move(Storage& from, Storage& to, std::true_type)
+    {
+        auto f = Get<F>(from, std::true_type());
+        new(to.buffer) F(std::move(*f));
+        f->~F();
+    }
+
+    template <typename F>
+    static void Move(Storage& from, Storage& to, std::false_type) { to.heap = from.heap; }
+
+    template <typename F>
+    static void Destroy(Storage& s, std::true_type) { Get<F>(s, std::true_type())->~F(); }
+
+    template <typename F>
+    static void Destroy(Storage& s, std::false_type) { RxPool::Delete(Get<F>(s, std::false_type())); }
+
+    template <typename F>
+    static const Ops* OpsFor()
+    {
+        using Inline = IsInline<F>;
+        static const Ops ops = {
+            [](Storage& s, Args... args) -> R
+            {
+                return static_cast<R>((*Get<F>(s, Inline()))(std::forward<Args>(args)...));
+            },
+            [](const Storage& from, Storage& to)
+            {
+                Construct<F>(to, Inline(), *Get<F>(from, Inline()));
+            },
+            [](Storage& from, Storage& to)
+            {
+                Move<F>(from, to, Inline());
+            },
+            [](Storage& s)
+            {
+                Destroy<F>(s, Inline());
+            }
+        };
+        return &ops;
+    }
+
+    template <typename F, typename = void>
+    struct IsCallable : std::false_type
+    {
+    };
+
+    template <typename F>
+    struct IsCallable<F, decltype(void(std::declval<F&>()(std::declval<Args>()...)))>
+        : std::integral_constant<bool, std::is_void<R>::value ||
+                                       std::is_convertible<decltype(std::declval<F&>()(std::declval<Args>()...)), R>::value>
+    {
+    };
+
+    // 呼び出し中の処理が自身の状態を書き換えられるよう、constなoperator()からも非constで扱う
+    mutable Storage storage;
+    const Ops* ops = nullptr;
+
+    void Reset() noexcept
+    {
+        if (ops == nullptr) return;
+
+        ops->destroy(storage);
+        ops = nullptr;
+    }
+
+public:
+    Function() = default;
+
+    Function(std::nullptr_t)
+    {
+    }
+
+    template <typename F,
+              typename D = typename std::decay<F>::type,
+              typename = typename std::enable_if<!std::is_same<D, Function>::value && IsCallable<D>::value>::type>
+    Function(F&& f)
+        : ops(OpsFor<D>())
+    {
+        Construct<D>(storage, IsInline<D>(), std::forward<F>(f));
+    }
+
+    Function(const Function& other)
+    {
+        if (other.ops == nullptr) return;
+
+        other.ops->copy(other.storage, storage);
+        ops = other.ops;
+    }
+
+    Function(Function&& other) noexcept
+    {
+        if (other.ops == nullptr) return;
+
+        other.ops->move(other.storage, storage);
+        ops = other.ops;
+        other.ops = nullptr;
+    }
+
+    Function& operator=(const Function& other)
+    {
+        if (this != &other) *this = Function(other);
+        return *this;
+    }
+
+    Function& operator=(Function&& other) noexcept
+    {
+        if (this == &other) return *this;
+
+        Reset();
+        if (other.ops != nullptr)
+        {
+            other.ops->move(other.storage, storage);
+            ops = other.ops;
+            other.ops = nullptr;
+        }
+        return *this;
+    }
+
+    Function& operator=(std::nullptr_t) noexcept
+    {
+        Reset();
+        return *this;
+    }
+
+    ~Function() { Reset(); }
+
+    R operator()(Args... args) const
+    {
+        return ops->invoke(storage, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const { return ops != nullptr; }
+
+    friend bool operator==(const Function& f, std::nullptr_t) { return f.ops == nullptr; }
+    friend bool operator!=(const Function& f, std::nullptr_t) { return f.ops != nullptr; }
+};
@@ -0,0 +1,115 @@
+#include "Instrumentation.h"
+
+#include <mutex>
+#include <vector>
+
+namespace Instrumentation
+{
+#if RX_INSTRUMENTATION
+    namespace
+    {
+        std::mutex registryMutex;
+        std::vector<std::weak_ptr<NodeStats>>& Registry()
+        {
+            static std::vector<std::weak_ptr<NodeStats>> registry;
+            return registry;
+        }
+
+        std::atomic<uint64_t> nextId{1};
+
+        // 生存しているノードの統計を集める (破棄済みのものはここで取り除く)
+        std::vector<Stats> Collect()
+        {
+            std::vector<Stats> res;
+            std::lock_guard<std::mutex> lock(registryMutex);
+
+            auto& registry = Registry();
+            for (auto itr = registry.begin(); itr != registry.end();)
+            {
+                if (auto node = itr->lock())
+                {
+                    res.push_back(GetStats(node));
+                    ++itr;
+                    continue;
+                }
+                itr = registry.erase(itr);
+            }
+            return res;
+        }
+    }
+
+    Node MakeNode(const char* name, const Node& parent)
+    {
+        auto node = std::make_shared<NodeStats>();
+        node->id = nextId.fetch_add(1, std::memory_order_relaxed);
+        node->parentId = parent != nullptr ? parent->id : 0;
+        node->name = name;
+
+        std::lock_guard<std::mutex> lock(registryMutex);
+        Registry().emplace_back(node);
+        return node;
+    }
+
+    Stats GetStats(const Node& node)
+    {
+        Stats s;
+        if (node == nullptr) return s;
+
+        s.id = node->id;
+        s.parentId = node->parentId;
+        s.name = node->name;
+        s.in = node->in.load(std::memory_order_relaxed);
+        s.out = node->out.load(std::memory_order_relaxed);
+        s.subscribers = node->subscribers.load(std::memory_order_relaxed);
+        s.pendingDispose = node->pendingDispose.load(std::memory_order_relaxed);
+        s.callbackNs = node->callbackNs.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    void WriteDot(std::ostream& os)
+    {
+        const auto nodes = Collect();
+
+        os << "digraph Rx {\n";
+        for (auto&& n : nodes)
+        {
+            os << "  n" << n.id << " [label=\"" << n.name << " #" << n.id
+                << "\\nin=" << n.in << " out=" << n.out;
+            if (n.in > 0) os << " pass=" << static_cast<double>(n.out) * 100.0 / static_cast<double>(n.in) << "%";
+            if (n.name == "Subject") os << "\\nsubscribers=" << n.subscribers << " pending=" << n.pendingDispose;
+            os << "\\ntime=" << n.callbackNs / 1000 << "us\"];\n";
+        }
+        for (auto&& n : nodes)
+        {
+            if (n.parentId != 0) os << "  n" << n.parentId << " -> n" << n.id << ";\n";
+        }
+        os << "}\n";
+    }
+
+    void WriteJson(std::ostream& os)
+    {
+        const auto nodes = Collect();
+
+        os << "[\n";
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            auto&& n = nodes[i];
+            os << "  {\"id\": " << n.id << ", \"parent\": " << n.parentId << ", \"name\": \"" << n.name
+                << "\", \"in\": " << n.in << ", \"out\": " << n.out << ", \"subscribers\": " << n.subscribers
+                << ", \"pending_dispose\": " << n.pendingDispose << ", \"callback_ns\": " << n.callbackNs << "}"
+                << (i + 1 < nodes.size() ? ",\n" : "\n");
+        }
+        os << "]\n";
+    }
+#else
+    void WriteDot(std::ostream& os)
+    {
+        os << "digraph Rx {\n}\n";
+    }
+
+    void WriteJson(std::ostream& os)
+    {
+        os << "[]\n";
+    }
+#endif
+}
@@ -0,0 +1,170 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "Observer.h"
+#include "Trace.h"
+
+// Subject/オペレータごとの通知数等を記録する計測機能
+// CMakeのRX_INSTRUMENTATIONオプション(RX_INSTRUMENTATION=1)で有効になり、無効時は何も生成されない
+// 有効時は生存しているノードのグラフを統計付きでDOT/JSONとして出力できる
+// トレース(RX_TRACING)が有効な場合は、各オペレータの処理区間もトレースに記録する
+#ifndef RX_INSTRUMENTATION
+#define RX_INSTRUMENTATION RX_TRACING
+#endif
+
+namespace Instrumentation
+{
+    // ある時点の統計
+    struct Stats
+    {
+        uint64_t id = 0;
+        uint64_t parentId = 0; // 0は親なし
+        std::string name;
+        uint64_t in = 0; // 受け取った値の数
+        uint64_t out = 0; // 下流へ流した値の数
+        int64_t subscribers = 0; // 現在の購読数 (Subjectのみ)
+        int64_t pendingDispose = 0; // 廃棄予定の購読数 (Subjectのみ)
+        uint64_t callbackNs = 0; // 値を受け取ってから下流の処理が終わるまでの累計時間
+    };
+
+#if RX_INSTRUMENTATION
+    struct NodeStats
+    {
+        uint64_t id;
+        uint64_t parentId;
+        const char* name;
+        std::atomic<uint64_t> in{0};
+        std::atomic<uint64_t> out{0};
+        std::atomic<int64_t> subscribers{0};
+        std::atomic<int64_t> pendingDispose{0};
+        std::atomic<uint64_t> callbackNs{0};
+    };
+
+    using Node = std::shared_ptr<NodeStats>;
+
+    // グラフにノードを登録する (破棄されると自動的にグラフから外れる)
+    Node MakeNode(const char* name, const Node& parent);
+
+    inline void AddIn(const Node& node, uint64_t n) { node->in.fetch_add(n, std::memory_order_relaxed); }
+    inline void AddOut(const Node& node, uint64_t n) { node->out.fetch_add(n, std::memory_order_relaxed); }
+
+    inline void SetSubscribers(const Node& node, size_t n)
+    {
+        node->subscribers.store(static_cast<int64_t>(n), std::memory_order_relaxed);
+    }
+
+    inline void SetPendingDispose(const Node& node, size_t n)
+    {
+        node->pendingDispose.store(static_cast<int64_t>(n), std::memory_order_relaxed);
+    }
+
+    // スコープ内の経過時間をcallbackNsに加算する
+    class ScopedTimer
+    {
+        NodeStats* node;
+        std::chrono::steady_clock::time_point begin;
+
+    public:
+        explicit ScopedTimer(const Node& node): node(node.get()), begin(std::chrono::steady_clock::now())
+        {
+        }
+
+        ~ScopedTimer()
+        {
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - begin).count();
+            node->callbackNs.fetch_add(static_cast<uint64_t>(ns), std::memory_order_relaxed);
+        }
+    };
+
+    // ノードが受け取った値を数えるObserver
+    template <typename T>
+    class InObserver : public Observer<T>
+    {
+        Node node;
+        ObserverPtr<T> inner;
+
+    public:
+        InObserver(Node node, ObserverPtr<T> inner)
+            : Observer<T>(nullptr, nullptr), node(std::move(node)), inner(std::move(inner))
+        {
+        }
+
+        void OnNext(const T& v) override
+        {
+            AddIn(node, 1);
+            Trace::Scope scope(node->name);
+            ScopedTimer timer(node);
+            inner->OnNext(v);
+        }
+
+        void OnNextBatch(const T* data, size_t n) override
+        {
+            AddIn(node, n);
+            Trace::Scope scope(node->name);
+            ScopedTimer timer(node);
+            inner->OnNextBatch(data, n);
+        }
+
+        void OnCompleted() override { inner->OnCompleted(); }
+    };
+
+    // ノードが下流へ流した値を数えるObserver
+    template <typename T>
+    class OutObserver : public Observer<T>
+    {
+        Node node;
+        ObserverPtr<T> inner;
+
+    public:
+        OutObserver(Node node, ObserverPtr<T> inner)
+            : Observer<T>(nullptr, nullptr), node(std::move(node)), inner(std::move(inner))
+        {
+        }
+
+        void OnNext(const T& v) override
+        {
+            AddOut(node, 1);
+            inner->OnNext(v);
+        }
+
+        void OnNextBatch(const T* data, size_t n) override
+        {
+            AddOut(node, n);
+            inner->OnNextBatch(data, n);
+        }
+
+        void OnCompleted() override { inner->OnCompleted(); }
+    };
+
+    template <typename T>
+    ObserverPtr<T> WrapIn(const Node& node, ObserverPtr<T> o)
+    {
+        return MakeObserver<InObserver<T>>(node, std::move(o));
+    }
+
+    template <typename T>
+    ObserverPtr<T> WrapOut(const Node& node, ObserverPtr<T> o)
+    {
+        return MakeObserver<OutObserver<T>>(node, std::move(o));
+    }
+
+    Stats GetStats(const Node& node);
+#else
+    // 無効時は空
+    struct Node
+    {
+    };
+
+    inline Stats GetStats(const Node&) { return Stats(); }
+#endif
+
+    // 生存しているノードのグラフを出力する (無効時は空のグラフ)
+    void WriteDot(std::ostream& os);
+    void WriteJson(std::ostream& os);
+}
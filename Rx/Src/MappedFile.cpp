@@ -0,0 +1,94 @@
+#include "MappedFile.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+
+MappedFile::MappedFile(const std::string& path, Access access)
+{
+    (void)access;
+
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                       FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        file = nullptr;
+        throw std::runtime_error("MappedFile: cannot open " + path);
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        throw std::runtime_error("MappedFile: cannot stat " + path);
+    }
+    size = static_cast<size_t>(fileSize.QuadPart);
+    if (size == 0) return;
+
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        CloseHandle(file);
+        throw std::runtime_error("MappedFile: cannot map " + path);
+    }
+
+    data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (data == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("MappedFile: cannot map " + path);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (data != nullptr) UnmapViewOfFile(data);
+    if (mapping != nullptr) CloseHandle(mapping);
+    if (file != nullptr) CloseHandle(file);
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path, Access access)
+{
+    const auto fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("MappedFile: cannot open " + path);
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        throw std::runtime_error("MappedFile: cannot stat " + path);
+    }
+    size = static_cast<size_t>(st.st_size);
+    if (size == 0)
+    {
+        close(fd);
+        return;
+    }
+
+    auto p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // マップした後はファイルを閉じても良い
+    close(fd);
+    if (p == MAP_FAILED) throw std::runtime_error("MappedFile: cannot map " + path);
+
+    madvise(p, size, access == Access::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+    data = static_cast<const unsigned char*>(p);
+}
+
+MappedFile::~MappedFile()
+{
+    if (data != nullptr) munmap(const_cast<unsigned char*>(data), size);
+}
+
+#endif
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "Span.h"
+
+// ファイル全体を読み込み専用でメモリにマップする
+// 開けない/マップできない場合はstd::runtime_errorを投げる。空のファイルはData()がnullptrでSize()が0になる
+class MappedFile
+{
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+#if defined(_WIN32)
+    void* file = nullptr; // HANDLE
+    void* mapping = nullptr; // HANDLE
+#endif
+
+public:
+    // OSへ伝える読み方のヒント (POSIXのmadvise。Windowsでは使わない)
+    enum class Access
+    {
+        Sequential, // 先頭から順に読む (先読みを増やし、読んだページは早めに手放してよい)
+        Random,
+    };
+
+    explicit MappedFile(const std::string& path, Access access = Access::Sequential);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* Data() const { return data; }
+    size_t Size() const { return size; }
+
+    // offsetバイト目からを固定長のレコードの並びとして見る (末尾の半端なバイトは含まない)
+    // レコードの位置がTのアラインメントに合わない場合はstd::runtime_errorを投げる
+    template <typename T>
+    Span<T> As(size_t offset = 0) const
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "mapped records must be trivially copyable");
+
+        if (offset >= size) return {};
+        if (reinterpret_cast<uintptr_t>(data + offset) % alignof(T) != 0)
+        {
+            throw std::runtime_error("MappedFile: records are not aligned");
+        }
+        return Span<T>(reinterpret_cast<const T*>(data + offset), (size - offset) / sizeof(T));
+    }
+};
@@ -1,11 +1,49 @@
-#pragma once
-#include <functional>
+﻿#pragma once
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
+#include "AssignableDisposable.h"
+#include "CompositeDisposable.h"
 #include "Disposable.h"
+#include "Function.h"
+#include "Instrumentation.h"
 #include "Observer.h"
+#include "Pipe.h"
+#include "RxPool.h"
+#include "Scheduler.h"
+#include "Span.h"
+#include "Trace.h"
+#include "Observer/BackpressureObserver.h"
+#include "Observer/BufferFrameObserver.h"
+#include "Observer/BufferObserver.h"
+#include "Observer/CombineLatestObserver.h"
+#include "Observer/DelayFrameObserver.h"
+#include "Observer/DistinctUntilChangedObserver.h"
+#include "Observer/ObserveOnObserver.h"
+#include "Observer/RecordObserver.h"
+#include "Observer/OperatorClock.h"
+#include "Observer/SampleObserver.h"
+#include "Observer/SelectObserver.h"
 #include "Observer/SkipObserver.h"
 #include "Observer/TakeObserver.h"
+#include "Observer/ThrottleFirstObserver.h"
+#include "Observer/ThrottleObserver.h"
 #include "Observer/IntervalObserver.h"
+#include "Observer/MergeObserver.h"
+#include "Observer/WhereObserver.h"
+#include "Observer/WindowObserver.h"
+#include "Observer/ZipObserver.h"
+
+template <typename T>
+class ConnectableObservable;
+
+#if RX_COROUTINES
+template <typename T>
+class FirstAsyncAwaiter;
+#endif
 
 // 同一メソッドチェーンSubscribeしなかった場合に、チェーンしたObservableのshared_ptrが解放されてしまうのを回避するためのクラス
 class ObservableRef
@@ -15,12 +53,207 @@ class ObservableRef
 template <typename T>
 class Observable : public ObservableRef, public std::enable_shared_from_this<Observable<T>>
 {
-    std::function<std::shared_ptr<Disposable>(std::shared_ptr<Observer<T>>)> subscribe;
+    Function<std::shared_ptr<Disposable>(ObserverPtr<T>)> subscribe;
     std::shared_ptr<Disposable> disposable;
     std::shared_ptr<ObservableRef> methodChainParent; // 解放されないようメソッドチェーンの親の参照を握っておく
+#if RX_INSTRUMENTATION
+    Instrumentation::Node node;
+#endif
+
+    // オペレータのObservableを作る共通処理。subscribeは購読ごとに呼ばれ、下流のObserverと、
+    // 上流へObserverを購読する関数を受け取って購読のDisposableを返す
+    // 計測有効時はオペレータをグラフのノードとして登録し、前後で通知を数える
+    template <typename U, typename F>
+    std::shared_ptr<Observable<U>> MakeOperator(const char* name, F subscribe)
+    {
+#if RX_INSTRUMENTATION
+        auto n = Instrumentation::MakeNode(name, node);
+        auto res = RxPool::MakeShared<Observable<U>>(
+            [this, n, subscribe](ObserverPtr<U> o)
+            {
+                return subscribe(Instrumentation::WrapOut<U>(n, std::move(o)), [this, &n](ObserverPtr<T> in)
+                {
+                    return Subscribe(Instrumentation::WrapIn<T>(n, std::move(in)));
+                });
+            },
+            disposable,
+            std::static_pointer_cast<ObservableRef>(this->shared_from_this())
+        );
+        res->AttachNode(n);
+        return res;
+#else
+        (void)name;
+        return RxPool::MakeShared<Observable<U>>(
+            [this, subscribe](ObserverPtr<U> o)
+            {
+                return subscribe(std::move(o), [this](ObserverPtr<T> in)
+                {
+                    return Subscribe(std::move(in));
+                });
+            },
+            disposable,
+            std::static_pointer_cast<ObservableRef>(this->shared_from_this())
+        );
+#endif
+    }
+
+    // オペレータのObservableを作る。makeObserverは下流のObserverを受け取り、上流へ登録するObserverを返す
+    template <typename U, typename F>
+    std::shared_ptr<Observable<U>> Operator(const char* name, F makeObserver)
+    {
+        return MakeOperator<U>(name, [makeObserver](ObserverPtr<U> o, const auto& subscribeUpstream)
+        {
+            return subscribeUpstream(makeObserver(std::move(o)));
+        });
+    }
+
+    // 自身の購読を廃棄するオペレータ(Take等)用。makeObserverは下流のObserverと、この購読のDisposableを受け取る
+    // 上流への購読が済む前(購読中の同期的な通知など)に廃棄されても良いよう、中身は購読後に設定する
+    // 購読中にその場で値を流す発行元がこの廃棄で止まれるよう、上流へ購読する間は保留中として設定しておく
+    template <typename U, typename F>
+    std::shared_ptr<Observable<U>> SubscriptionOperator(const char* name, F makeObserver)
+    {
+        return MakeOperator<U>(name, [makeObserver](ObserverPtr<U> o, const auto& subscribeUpstream)
+            -> std::shared_ptr<Disposable>
+        {
+            auto subscription = RxPool::MakeShared<AssignableDisposable>();
+            auto observer = makeObserver(std::move(o), subscription);
+            AssignableDisposable::PendingScope pending(subscription.get());
+            subscription->SetInner(subscribeUpstream(std::move(observer)));
+            return subscription;
+        });
+    }
+
+    // 下流への転送処理(OnNext/OnCompleted/OnNextBatch)とargsを渡してObserverを作る
+    // 転送処理は下流を生ポインタで参照し、下流の所有は作ったObserverが1つだけ持つ
+    // (所有の参照カウントは既定では不可分な増減、RX_SINGLE_THREADED有効時は不可分でない増減になる。ObserverPtr.h参照)
+    template <typename U, typename F, typename... Args>
+    static auto Forward(ObserverPtr<U> o, const F& makeObserver, Args&&... args)
+    {
+        auto* p = o.get();
+        auto observer = makeObserver(
+            [p](const U& v) { p->OnNext(v); },
+            [p] { p->OnCompleted(); },
+            [p](const U* data, size_t n) { p->OnNextBatch(data, n); },
+            std::forward<Args>(args)...
+        );
+        observer->HoldDownstream(std::move(o));
+        return observer;
+    }
+
+    // 下流への転送処理を受け取ってObserverを作るオペレータ用
+    template <typename U, typename F>
+    std::shared_ptr<Observable<U>> ForwardOperator(const char* name, F makeObserver)
+    {
+        return Operator<U>(name, [makeObserver](ObserverPtr<U> o)
+        {
+            return Forward(std::move(o), makeObserver);
+        });
+    }
+
+    // 自身の購読を廃棄するForwardOperator (makeObserverは転送処理に続いてこの購読のDisposableを受け取る)
+    template <typename U, typename F>
+    std::shared_ptr<Observable<U>> ForwardSubscriptionOperator(const char* name, F makeObserver)
+    {
+        return SubscriptionOperator<U>(name, [makeObserver](ObserverPtr<U> o, std::shared_ptr<Disposable> subscription)
+        {
+            return Forward(std::move(o), makeObserver, std::move(subscription));
+        });
+    }
+
+    // 背圧オペレータ共通
+    std::shared_ptr<Observable<T>> OnBackpressure(const char* name,
+                                                  size_t capacity,
+                                                  typename BackpressureObserver<T>::Overflow overflow,
+                                                  std::shared_ptr<Scheduler> scheduler,
+                                                  std::shared_ptr<BackpressureStats> stats)
+    {
+        return SubscriptionOperator<T>(name, [=](ObserverPtr<T> o, std::shared_ptr<Disposable> d)
+        {
+            return MakeObserver<BackpressureObserver<T>>(o, scheduler, d, capacity, overflow, stats);
+        });
+    }
+
+    // 複数のObservable(sourcesの先頭は自身)を購読するObservableを作る
+    // makeObservers(下流のObserver)は購読ごとに呼ばれ、入力の番号(integral_constant)からその入力へ登録するObserverを作る関数を返す
+    template <typename U, typename Sources, typename F>
+    std::shared_ptr<Observable<U>> Combine(const char* name, Sources sources, F makeObservers)
+    {
+        using Indices = std::make_index_sequence<std::tuple_size<Sources>::value>;
+
+        // 派生したObservableから廃棄する場合は全ての入力を廃棄する
+        auto d = RxPool::MakeShared<CompositeDisposable>();
+        AddSourceDisposables(*d, sources, Indices());
+
+        Instrumentation::Node n{};
+#if RX_INSTRUMENTATION
+        n = Instrumentation::MakeNode(name, node);
+#else
+        (void)name;
+#endif
+
+        auto res = RxPool::MakeShared<Observable<U>>(
+            [=](ObserverPtr<U> o) -> std::shared_ptr<Disposable>
+            {
+#if RX_INSTRUMENTATION
+                o = Instrumentation::WrapOut<U>(n, o);
+#endif
+                auto make = makeObservers(o);
+                auto subscription = RxPool::MakeShared<CompositeDisposable>();
+                SubscribeInputs(*subscription, sources, make, n, Indices());
+                return subscription;
+            },
+            d,
+            std::static_pointer_cast<ObservableRef>(this->shared_from_this())
+        );
+        res->AttachNode(n);
+        return res;
+    }
+
+    template <typename Sources, size_t... Is>
+    static void AddSourceDisposables(CompositeDisposable& into, const Sources& sources, std::index_sequence<Is...>)
+    {
+        const int add[] = {(into.Add(std::get<Is>(sources)->GetDisposable()), 0)...};
+        (void)add;
+    }
+
+    template <typename Sources, typename Make, size_t... Is>
+    static void SubscribeInputs(CompositeDisposable& into, const Sources& sources, Make& make,
+                                const Instrumentation::Node& n, std::index_sequence<Is...>)
+    {
+        const int subscribe[] = {(into.Add(SubscribeInput<Is>(sources, make, n)), 0)...};
+        (void)subscribe;
+    }
+
+    template <size_t I, typename Sources, typename Make>
+    static std::shared_ptr<Disposable> SubscribeInput(const Sources& sources, Make& make, const Instrumentation::Node& n)
+    {
+        using V = typename std::decay<decltype(*std::get<I>(sources))>::type::ValueType;
+
+        ObserverPtr<V> o = make(std::integral_constant<size_t, I>());
+#if RX_INSTRUMENTATION
+        o = Instrumentation::WrapIn<V>(n, o);
+#else
+        (void)n;
+#endif
+        return std::get<I>(sources)->Subscribe(o);
+    }
+
+    template <typename... Us>
+    static constexpr bool AllSameAsT()
+    {
+        const bool same[] = {true, std::is_same<T, Us>::value...};
+        for (auto b : same)
+        {
+            if (!b) return false;
+        }
+        return true;
+    }
 
 public:
-    Observable(std::function<std::shared_ptr<Disposable>(std::shared_ptr<Observer<T>>)> subscribe,
+    using ValueType = T;
+
+    Observable(Function<std::shared_ptr<Disposable>(ObserverPtr<T>)> subscribe,
                std::shared_ptr<Disposable> disposable,
                std::shared_ptr<ObservableRef> methodChainParent)
         : subscribe(std::move(subscribe)),
@@ -29,142 +262,438 @@ public:
     {
     }
 
+    std::shared_ptr<Disposable> Subscribe(ObserverPtr<T> observer) const
+    {
+        return subscribe(std::move(observer));
+    }
+
+#if RX_SINGLE_THREADED
+    // shared_ptrで作ったObserverは転送用のObserverで包んで購読する
     std::shared_ptr<Disposable> Subscribe(std::shared_ptr<Observer<T>> observer) const
     {
-        return subscribe(observer);
+        return subscribe(MakeObserver<SharedObserver<T>>(std::move(observer)));
     }
+#endif
 
-    std::shared_ptr<Disposable> Subscribe(std::function<void(T)> onNext,
-                                          std::function<void()> onCompleted = nullptr) const
+    // このObservableからの購読全体を廃棄するためのDisposable (廃棄は取り消されず、以降の購読は登録と同時に廃棄される)
+    // 購読1つ分の廃棄にはSubscribeの返り値を使う
+    const std::shared_ptr<Disposable>& GetDisposable() const { return disposable; }
+
+    // 計測用のノード (計測無効時は空)
+    Instrumentation::Node GetNode() const
     {
-        return Subscribe(std::make_shared<Observer<T>>(
-            [=](const T& v)
-            {
-                onNext(v);
-            },
-            [=]
-            {
-                if (onCompleted != nullptr) onCompleted();
-            }
-        ));
+#if RX_INSTRUMENTATION
+        return node;
+#else
+        return {};
+#endif
+    }
+
+    // 計測用のノードを設定する (計測無効時は何もしない)
+    void AttachNode(const Instrumentation::Node& n)
+    {
+#if RX_INSTRUMENTATION
+        node = n;
+#else
+        (void)n;
+#endif
+    }
+
+    std::shared_ptr<Disposable> Subscribe(Function<void(const T&)> onNext,
+                                          Function<void()> onCompleted = nullptr) const
+    {
+#if RX_TRACING
+        // 購読者の処理もトレースに記録する
+        onNext = [f = std::move(onNext)](const T& v)
+        {
+            Trace::Scope scope("Subscriber::OnNext");
+            f(v);
+        };
+#endif
+
+        // 完了時の処理が無ければ空のまま渡す (Observerは空なら呼ばない)
+        return Subscribe(MakeObserver<Observer<T>>(std::move(onNext), std::move(onCompleted)));
+    }
+
+    // オペレータを型として合成し、1つの呼び出しに融合したチェーンを作る (詳細はPipe.h)
+    template <typename... Ops>
+    std::shared_ptr<PipeObservable<T, Ops...>> Pipe(Ops... ops)
+    {
+        return RxPool::MakeShared<PipeObservable<T, Ops...>>(this->shared_from_this(), std::make_tuple(std::move(ops)...));
     }
 
     template <typename Ret>
-    std::shared_ptr<Observable<Ret>> Select(std::function<Ret(T)> select)
+    std::shared_ptr<Observable<Ret>> Select(Function<Ret(const T&)> select)
     {
-        return std::make_shared<Observable<Ret>>(
-            [=](std::shared_ptr<Observer<Ret>> o)
-            {
-                return Subscribe(
-                    [=](const T& v)
-                    {
-                        o->OnNext(select(v));
-                    },
-                    [=]
-                    {
-                        o->OnCompleted();
-                    }
-                );
-            },
-            disposable,
-            std::static_pointer_cast<ObservableRef>(this->shared_from_this())
-        );
+        return ForwardOperator<Ret>("Select", [=](auto onNext, auto onCompleted, auto onNextBatch)
+        {
+            return MakeObserver<SelectObserver<T, Ret>>(
+                std::move(onNext),
+                std::move(onCompleted),
+                select,
+                std::move(onNextBatch)
+            );
+        });
     }
 
-    std::shared_ptr<Observable<T>> Where(std::function<bool(T)> where)
+    std::shared_ptr<Observable<T>> Where(Function<bool(const T&)> where)
     {
-        return std::make_shared<Observable<T>>(
-            [=](std::shared_ptr<Observer<T>> o)
-            {
-                return Subscribe(
-                    [=](const T& v)
-                    {
-                        if (where(v))
-                        {
-                            o->OnNext(v);
-                        }
-                    },
-                    [=]
-                    {
-                        o->OnCompleted();
-                    }
-                );
-            },
-            disposable,
-            std::static_pointer_cast<ObservableRef>(this->shared_from_this())
-        );
+        return ForwardOperator<T>("Where", [=](auto onNext, auto onCompleted, auto onNextBatch)
+        {
+            return MakeObserver<WhereObserver<T>>(
+                std::move(onNext),
+                std::move(onCompleted),
+                where,
+                std::move(onNextBatch)
+            );
+        });
+    }
+
+    // 直前の値と同じ値を捨てる (==で比べる)
+    std::shared_ptr<Observable<T>> DistinctUntilChanged()
+    {
+        return DistinctUntilChanged<T>([](const T& v) { return v; });
+    }
+
+    // keySelectorで取り出したキーが直前と同じ値を捨てる
+    // comparerを指定しない場合はキーを==で比べる
+    template <typename Key>
+    std::shared_ptr<Observable<T>> DistinctUntilChanged(Function<Key(const T&)> keySelector,
+                                                        Function<bool(const Key&, const Key&)> comparer = nullptr)
+    {
+        return ForwardOperator<T>("DistinctUntilChanged", [=](auto onNext, auto onCompleted, auto onNextBatch)
+        {
+            return MakeObserver<DistinctUntilChangedObserver<T, Key>>(
+                std::move(onNext),
+                std::move(onCompleted),
+                keySelector,
+                comparer,
+                std::move(onNextBatch)
+            );
+        });
     }
 
     std::shared_ptr<Observable<T>> Skip(int num)
     {
-        return std::make_shared<Observable<T>>(
-            [=](std::shared_ptr<Observer<T>> o)
-            {
-                return Subscribe(
-                    std::make_shared<SkipObserver<T>>(
-                        [=](const T& v)
-                        {
-                            o->OnNext(v);
-                        },
-                        [=]
-                        {
-                            o->OnCompleted();
-                        },
-                        num
-                    )
-                );
-            },
-            disposable,
-            std::static_pointer_cast<ObservableRef>(this->shared_from_this())
-        );
+        return ForwardOperator<T>("Skip", [=](auto onNext, auto onCompleted, auto onNextBatch)
+        {
+            return MakeObserver<SkipObserver<T>>(
+                std::move(onNext),
+                std::move(onCompleted),
+                num,
+                std::move(onNextBatch)
+            );
+        });
     }
 
     std::shared_ptr<Observable<T>> Take(int num)
     {
-        return std::make_shared<Observable<T>>(
-            [=](std::shared_ptr<Observer<T>> o)
-            {
-                return Subscribe(
-                    std::make_shared<TakeObserver<T>>(
-                        [=](const T& v)
-                        {
-                            o->OnNext(v);
-                        },
-                        [=]
-                        {
-                            o->OnCompleted();
-                        },
-                        num,
-                        disposable
-                    )
-                );
-            },
-            disposable,
-            std::static_pointer_cast<ObservableRef>(this->shared_from_this())
-        );
+        return ForwardSubscriptionOperator<T>("Take", [=](auto onNext, auto onCompleted, auto onNextBatch, auto d)
+        {
+            return MakeObserver<TakeObserver<T>>(
+                std::move(onNext),
+                std::move(onCompleted),
+                num,
+                d,
+                std::move(onNextBatch)
+            );
+        });
     }
 
     std::shared_ptr<Observable<T>> Interval(int num)
     {
-        return std::make_shared<Observable<T>>(
-            [=](std::shared_ptr<Observer<T>> o)
+        return ForwardOperator<T>("Interval", [=](auto onNext, auto onCompleted, auto onNextBatch)
+        {
+            return MakeObserver<IntervalObserver<T>>(
+                std::move(onNext),
+                std::move(onCompleted),
+                num,
+                std::move(onNextBatch)
+            );
+        });
+    }
+
+    // 流れた値をフレーム番号と時刻付きでpathのバイナリのログに記録する (値はそのまま下流へ流す)
+    // ファイルは呼び出し時に開き(開けなければstd::runtime_error)、作ったObservableとその購読が全て無くなった時点で閉じる
+    // 流し直すにはReplay(EventLog.h)を使う
+    std::shared_ptr<Observable<T>> Record(const std::string& path)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Record requires a trivially copyable value type");
+
+        return Record(RxPool::MakeShared<EventLogWriter>(path, static_cast<uint32_t>(sizeof(T))));
+    }
+
+    // 指定のライターへ記録する (閉じるタイミングを自分で決める場合や、複数のストリームを1つのログへまとめる場合)
+    std::shared_ptr<Observable<T>> Record(std::shared_ptr<EventLogWriter> writer)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Record requires a trivially copyable value type");
+
+        return ForwardOperator<T>("Record", [=](auto onNext, auto onCompleted, auto onNextBatch)
+        {
+            return MakeObserver<RecordObserver<T>>(
+                std::move(onNext),
+                std::move(onCompleted),
+                writer,
+                std::move(onNextBatch)
+            );
+        });
+    }
+
+    // count個ずつまとめて流す。下流に渡すSpanは通知中のみ有効
+    std::shared_ptr<Observable<Span<T>>> Buffer(int count)
+    {
+        return Buffer(count, count);
+    }
+
+    // count個ずつまとめて、skip個ごとに流す (skip < countなら重なり、skip > countなら間を読み飛ばす)
+    std::shared_ptr<Observable<Span<T>>> Buffer(int count, int skip)
+    {
+        return Operator<Span<T>>("Buffer", [=](ObserverPtr<Span<T>> o)
+        {
+            return MakeObserver<BufferObserver<T>>(o, count, skip);
+        });
+    }
+
+    // numフレームの間に受け取った値をまとめて流す (フレームはObservableUtil::DoEveryUpdateで進む)
+    std::shared_ptr<Observable<Span<T>>> BufferFrame(int num)
+    {
+        return SubscriptionOperator<Span<T>>("BufferFrame", [=](ObserverPtr<Span<T>> o, std::shared_ptr<Disposable> d)
+        {
+            return MakeObserver<BufferFrameObserver<T>>(o, num, d);
+        });
+    }
+
+    // count個ずつの区切りごとに、その区切りの値を流すObservableを流す (skip個ごとに新しい区切りを開く)
+    std::shared_ptr<Observable<std::shared_ptr<Observable<T>>>> Window(int count, int skip = 0)
+    {
+        using Inner = std::shared_ptr<Observable<T>>;
+        const auto s = skip > 0 ? skip : count;
+
+        return Operator<Inner>("Window", [=](ObserverPtr<Inner> o)
+        {
+            return MakeObserver<WindowObserver<T>>(o, count, s);
+        });
+    }
+
+    // 値と完了通知を指定フレーム数だけ遅らせて流す (フレームはObservableUtil::DoEveryUpdateで進む)
+    std::shared_ptr<Observable<T>> DelayFrame(int num)
+    {
+        return SubscriptionOperator<T>("DelayFrame", [=](ObserverPtr<T> o, std::shared_ptr<Disposable> d)
+        {
+            return MakeObserver<DelayFrameObserver<T>>(o, num, d);
+        });
+    }
+
+    // 値を流したら、その後指定フレーム数の間に届いた値は捨てる
+    std::shared_ptr<Observable<T>> ThrottleFirstFrame(int frames)
+    {
+        const auto interval = static_cast<FrameClock::Duration>(frames > 0 ? frames : 0);
+
+        return Operator<T>("ThrottleFirstFrame", [=](ObserverPtr<T> o)
+        {
+            return MakeObserver<ThrottleFirstObserver<T, FrameClock>>(o, interval);
+        });
+    }
+
+    // 値を流したら、その後指定時間の間に届いた値は捨てる
+    std::shared_ptr<Observable<T>> ThrottleFirst(SteadyClock::Duration interval)
+    {
+        return Operator<T>("ThrottleFirst", [=](ObserverPtr<T> o)
+        {
+            return MakeObserver<ThrottleFirstObserver<T, SteadyClock>>(o, interval);
+        });
+    }
+
+    // 指定フレーム数の間、次の値が届かなかったら最後の値を流す (Debounce)
+    std::shared_ptr<Observable<T>> ThrottleFrame(int frames)
+    {
+        const auto due = static_cast<FrameClock::Duration>(frames > 0 ? frames : 1);
+
+        return SubscriptionOperator<T>("ThrottleFrame", [=](ObserverPtr<T> o, std::shared_ptr<Disposable> d)
+        {
+            return MakeObserver<ThrottleObserver<T, FrameClock>>(o, due, d);
+        });
+    }
+
+    // 指定時間の間、次の値が届かなかったら最後の値を流す (Debounce)
+    // 時間の経過はフレームごとに確かめるので、流れるのは期限を過ぎた次のフレーム
+    std::shared_ptr<Observable<T>> Throttle(SteadyClock::Duration due)
+    {
+        return SubscriptionOperator<T>("Throttle", [=](ObserverPtr<T> o, std::shared_ptr<Disposable> d)
+        {
+            return MakeObserver<ThrottleObserver<T, SteadyClock>>(o, due, d);
+        });
+    }
+
+    // 指定フレーム数ごとに、その間に届いた最新の値を流す
+    std::shared_ptr<Observable<T>> SampleFrame(int frames)
+    {
+        const auto interval = static_cast<FrameClock::Duration>(frames > 0 ? frames : 1);
+
+        return SubscriptionOperator<T>("SampleFrame", [=](ObserverPtr<T> o, std::shared_ptr<Disposable> d)
+        {
+            return MakeObserver<SampleObserver<T, FrameClock>>(o, interval, d);
+        });
+    }
+
+    // 指定時間ごとに、その間に届いた最新の値を流す
+    // 時間の経過はフレームごとに確かめるので、流れるのは期限を過ぎた次のフレーム
+    std::shared_ptr<Observable<T>> Sample(SteadyClock::Duration interval)
+    {
+        return SubscriptionOperator<T>("Sample", [=](ObserverPtr<T> o, std::shared_ptr<Disposable> d)
+        {
+            return MakeObserver<SampleObserver<T, SteadyClock>>(o, interval, d);
+        });
+    }
+
+    // 以降の処理(下流への通知)を指定のスケジューラ上で行う。購読ごとに通知の順序は保たれる
+    std::shared_ptr<Observable<T>> ObserveOn(std::shared_ptr<Scheduler> scheduler)
+    {
+        return SubscriptionOperator<T>("ObserveOn", [=](ObserverPtr<T> o, std::shared_ptr<Disposable> d)
+        {
+            return MakeObserver<ObserveOnObserver<T>>(o, scheduler, d);
+        });
+    }
+
+    // 自身とothersの値をまとめて流す。全て完了したら完了する
+    template <typename... Us>
+    std::shared_ptr<Observable<T>> Merge(const std::shared_ptr<Observable<Us>>&... others)
+    {
+        static_assert(AllSameAsT<Us...>(), "Merge requires observables of the same type");
+
+        return Combine<T>("Merge", std::make_tuple(this->shared_from_this(), others...), [](ObserverPtr<T> o)
+        {
+            auto state = RxPool::MakeShared<typename MergeObserver<T>::State>();
+            state->downstream = std::move(o);
+            state->remaining = 1 + sizeof...(Us);
+
+            return [state](auto) -> ObserverPtr<T>
             {
-                return Subscribe(
-                    std::make_shared<IntervalObserver<T>>(
-                        [=](const T& v)
-                        {
-                            o->OnNext(v);
-                        },
-                        [=]
-                        {
-                            o->OnCompleted();
-                        },
-                        num
-                    )
-                );
+                return MakeObserver<MergeObserver<T>>(state);
+            };
+        });
+    }
+
+    // 自身とothersのいずれかが値を受け取るたびに、それぞれの最新の値の組を流す
+    template <typename... Us>
+    std::shared_ptr<Observable<std::tuple<T, Us...>>> CombineLatest(const std::shared_ptr<Observable<Us>>&... others)
+    {
+        using Tuple = std::tuple<T, Us...>;
+
+        return Combine<Tuple>("CombineLatest", std::make_tuple(this->shared_from_this(), others...), [](ObserverPtr<Tuple> o)
+        {
+            auto state = RxPool::MakeShared<CombineLatestState<T, Us...>>();
+            state->downstream = std::move(o);
+
+            return [state](auto index)
+            {
+                return MakeObserver<CombineLatestObserver<decltype(index)::value, T, Us...>>(state);
+            };
+        });
+    }
+
+    // 自身とothersのn番目の値同士を組にして流す
+    // 先行している入力の値は入力ごとにcapacity個まで溜め、超えた場合は受け取った値を捨てる
+    // 捨てた数はstatsに加算される
+    template <typename... Us>
+    std::shared_ptr<Observable<std::tuple<T, Us...>>> Zip(size_t capacity,
+                                                          std::shared_ptr<BackpressureStats> stats,
+                                                          const std::shared_ptr<Observable<Us>>&... others)
+    {
+        using Tuple = std::tuple<T, Us...>;
+
+        return Combine<Tuple>("Zip", std::make_tuple(this->shared_from_this(), others...), [capacity, stats](ObserverPtr<Tuple> o)
+        {
+            auto state = RxPool::MakeShared<ZipState<T, Us...>>(capacity, stats);
+            state->downstream = std::move(o);
+
+            return [state](auto index)
+            {
+                return MakeObserver<ZipObserver<decltype(index)::value, T, Us...>>(state);
+            };
+        });
+    }
+
+    template <typename... Us>
+    std::shared_ptr<Observable<std::tuple<T, Us...>>> Zip(size_t capacity, const std::shared_ptr<Observable<Us>>&... others)
+    {
+        return Zip(capacity, nullptr, others...);
+    }
+
+    template <typename... Us>
+    std::shared_ptr<Observable<std::tuple<T, Us...>>> Zip(const std::shared_ptr<Observable<Us>>&... others)
+    {
+        return Zip(DefaultZipCapacity, others...);
+    }
+
+    // 上流を1度だけ購読して全ての購読者へ流すObservableを作る。上流へはConnectで接続する
+    std::shared_ptr<ConnectableObservable<T>> Publish()
+    {
+        return RxPool::MakeShared<ConnectableObservable<T>>(this->shared_from_this());
+    }
+
+    // 購読者がいる間だけ上流に接続し、上流を1度だけ購読して全ての購読者へ流す (Publish()->RefCount())
+    std::shared_ptr<Observable<T>> Share()
+    {
+        return Publish()->RefCount();
+    }
+
+    // 下流への通知を指定のスケジューラ上で行い、通知待ちの値が容量を超えたら新しい値を捨てる
+    // 捨てた数はstatsに加算される
+    std::shared_ptr<Observable<T>> OnBackpressureBuffer(size_t capacity,
+                                                        std::shared_ptr<Scheduler> scheduler = Scheduler::MainThread(),
+                                                        std::shared_ptr<BackpressureStats> stats = nullptr)
+    {
+        return OnBackpressure("OnBackpressureBuffer", capacity, BackpressureObserver<T>::Overflow::DropNewest, std::move(scheduler), std::move(stats));
+    }
+
+    // 下流への通知を指定のスケジューラ上で行い、通知待ちの値がある間に届いた値は捨てる
+    std::shared_ptr<Observable<T>> OnBackpressureDrop(std::shared_ptr<Scheduler> scheduler = Scheduler::MainThread(),
+                                                      std::shared_ptr<BackpressureStats> stats = nullptr)
+    {
+        return OnBackpressure("OnBackpressureDrop", 1, BackpressureObserver<T>::Overflow::DropNewest, std::move(scheduler), std::move(stats));
+    }
+
+    // 下流への通知を指定のスケジューラ上で行い、通知待ちの値は最新の1つだけを残す
+    std::shared_ptr<Observable<T>> OnBackpressureLatest(std::shared_ptr<Scheduler> scheduler = Scheduler::MainThread(),
+                                                        std::shared_ptr<BackpressureStats> stats = nullptr)
+    {
+        return OnBackpressure("OnBackpressureLatest", 1, BackpressureObserver<T>::Overflow::DropOldest, std::move(scheduler), std::move(stats));
+    }
+
+#if RX_COROUTINES
+    // co_awaitで最初の値を待つ (詳細はCoroutine.h)
+    FirstAsyncAwaiter<T> FirstAsync() const;
+#endif
+
+    // 上流への購読処理を指定のスケジューラ上で行う
+    // 注意: Subjectはスレッドセーフではないので、スレッドプール上で購読する場合はConcurrentSubjectを使うこと
+    std::shared_ptr<Observable<T>> SubscribeOn(std::shared_ptr<Scheduler> scheduler)
+    {
+        auto self = this->shared_from_this();
+
+        return RxPool::MakeShared<Observable<T>>(
+            [=](ObserverPtr<T> o) -> std::shared_ptr<Disposable>
+            {
+                auto d = RxPool::MakeShared<AssignableDisposable>();
+                scheduler->Schedule([=]
+                {
+                    if (d->IsDisposed()) return;
+
+                    d->SetInner(self->Subscribe(o));
+                });
+                return d;
             },
             disposable,
-            std::static_pointer_cast<ObservableRef>(this->shared_from_this())
+            std::static_pointer_cast<ObservableRef>(self)
         );
     }
 };
+
+// Publishが返す型 (Observableを継承するので、Observableの定義の後で読み込む)
+#include "ConnectableObservable.h"
+
+#if RX_COROUTINES
+// FirstAsyncが返す型 (Observableの定義の後で読み込む)
+#include "Coroutine.h"
+#endif
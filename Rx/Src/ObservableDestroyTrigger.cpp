@@ -3,10 +3,10 @@
 
 ObservableDestroyTrigger::~ObservableDestroyTrigger()
 {
-    if (auto p = _disposable.lock()) p->Dispose();
+    _disposables.Dispose();
 }
 
-void ObservableDestroyTrigger::AddDisposableOnDestroy(std::weak_ptr<Disposable> disposable)
+void ObservableDestroyTrigger::AddDisposableOnDestroy(std::shared_ptr<Disposable> disposable)
 {
-    _disposable = disposable;
+    _disposables.Add(std::move(disposable));
 }
@@ -1,14 +1,15 @@
 ﻿#pragma once
 #include <memory>
 
-class Disposable;
+#include "CompositeDisposable.h"
 
+// 破棄時にAddToされた購読を全て廃棄する
 class ObservableDestroyTrigger
 {
-    std::weak_ptr<Disposable> _disposable;
+    CompositeDisposable _disposables;
 
 public:
     virtual ~ObservableDestroyTrigger();
 
-    void AddDisposableOnDestroy(std::weak_ptr<Disposable> disposable);
+    void AddDisposableOnDestroy(std::shared_ptr<Disposable> disposable);
 };
@@ -3,4 +3,83 @@
 namespace ObservableUtil
 {
     std::shared_ptr<Subject<Unit>> everyUpdateSubject = std::make_shared<Subject<Unit>>();
+
+    EveryUpdateObservable::EveryUpdateObservable(const std::shared_ptr<Observable<Unit>>& source)
+        : Observable<Unit>(
+            [source](ObserverPtr<Unit> o)
+            {
+                return source->Subscribe(o);
+            },
+            source->GetDisposable(),
+            source)
+    {
+    }
+
+    std::shared_ptr<Observable<Unit>> EveryUpdateObservable::Interval(int num)
+    {
+        auto disposer = RxPool::MakeShared<CompositeDisposable>();
+        const auto period = static_cast<uint32_t>(num > 0 ? num : 1);
+
+        return RxPool::MakeShared<Observable<Unit>>(
+            [=](ObserverPtr<Unit> o) -> std::shared_ptr<Disposable>
+            {
+                auto timer = FrameTimerWheel::Main().Schedule(period, [o] { o->OnNext(Unit()); }, period);
+                disposer->Add(timer);
+                return timer;
+            },
+            disposer,
+            std::static_pointer_cast<ObservableRef>(shared_from_this())
+        );
+    }
+
+    std::shared_ptr<Observable<Unit>> EveryUpdateObservable::Skip(int num)
+    {
+        if (num <= 0) return shared_from_this();
+
+        auto self = shared_from_this();
+        auto disposer = RxPool::MakeShared<CompositeDisposable>();
+
+        return RxPool::MakeShared<Observable<Unit>>(
+            [=](ObserverPtr<Unit> o) -> std::shared_ptr<Disposable>
+            {
+                // 購読ごとに、待ちのタイマーと後から行う購読をまとめて廃棄できるようにする
+                auto subscription = RxPool::MakeShared<CompositeDisposable>();
+                std::weak_ptr<CompositeDisposable> weakSubscription = subscription;
+
+                // numフレーム目の通知が済んだ後に購読するので、次のフレームから流れる
+                subscription->Add(FrameTimerWheel::Main().Schedule(static_cast<uint32_t>(num), [=]
+                {
+                    auto d = weakSubscription.lock();
+                    if (d == nullptr || d->IsDisposed()) return;
+
+                    d->Add(self->Subscribe(o));
+                }));
+                disposer->Add(subscription);
+                return subscription;
+            },
+            disposer,
+            std::static_pointer_cast<ObservableRef>(self)
+        );
+    }
+
+    std::shared_ptr<Observable<Unit>> TimerFrame(int num)
+    {
+        auto disposer = RxPool::MakeShared<CompositeDisposable>();
+        const auto delay = static_cast<uint32_t>(num > 0 ? num : 1);
+
+        return RxPool::MakeShared<Observable<Unit>>(
+            [=](ObserverPtr<Unit> o) -> std::shared_ptr<Disposable>
+            {
+                auto timer = FrameTimerWheel::Main().Schedule(delay, [o]
+                {
+                    o->OnNext(Unit());
+                    o->OnCompleted();
+                });
+                disposer->Add(timer);
+                return timer;
+            },
+            disposer,
+            nullptr
+        );
+    }
 }
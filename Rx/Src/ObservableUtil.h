@@ -1,21 +1,119 @@
 ﻿#pragma once
 #include <memory>
+#include <string>
 
+#include "AssignableDisposable.h"
+#include "CompositeDisposable.h"
+#include "FrameTimerWheel.h"
+#include "MappedFile.h"
 #include "Observable.h"
+#include "Scheduler.h"
 #include "Unit.h"
 #include "Subject.h"
 
 namespace ObservableUtil
 {
     extern std::shared_ptr<Subject<Unit>> everyUpdateSubject;
-    
-    inline std::shared_ptr<Observable<Unit>> EveryUpdate()
+
+    // EveryUpdate()が返すObservable
+    // フレームを数えるだけのオペレータは毎フレーム通知を受ける代わりにFrameTimerWheelへ登録し、
+    // 待っている間はコストがかからないようにする
+    class EveryUpdateObservable : public Observable<Unit>
+    {
+    public:
+        explicit EveryUpdateObservable(const std::shared_ptr<Observable<Unit>>& source);
+
+        // numフレームごとに通知する
+        std::shared_ptr<Observable<Unit>> Interval(int num);
+
+        // numフレーム経過後から毎フレーム通知する
+        std::shared_ptr<Observable<Unit>> Skip(int num);
+    };
+
+    inline std::shared_ptr<EveryUpdateObservable> EveryUpdate()
     {
-        return everyUpdateSubject->GetObservable();
+        return RxPool::MakeShared<EveryUpdateObservable>(everyUpdateSubject->GetObservable());
+    }
+
+    // 他の購読者と状態を共有しない毎フレームの処理用 (everyUpdateSubject->SetParallelDispatch()で並列に実行される)
+    inline std::shared_ptr<EveryUpdateObservable> EveryUpdateIndependent()
+    {
+        return RxPool::MakeShared<EveryUpdateObservable>(everyUpdateSubject->GetIndependentObservable());
+    }
+
+    // numフレーム後に1度だけ通知して完了する
+    std::shared_ptr<Observable<Unit>> TimerFrame(int num);
+
+    // FromMappedFileが1度に流すレコード数
+    constexpr size_t DefaultMappedChunkSize = 4096;
+
+    // マップしたファイルのoffsetバイト目からを固定長のレコードTの並びとして、購読時にその場で全て流して完了する
+    // 値はコピーせずマップした領域を直接参照して流す。chunkSize件ずつOnNextBatchで流し、0なら1件ずつOnNextで流す
+    // 廃棄(Take等)されたらチャンク/レコードの区切りで止まる。Subscribeが戻る前の下流の廃棄も、保留中の
+    // AssignableDisposableへ購読を結び付けておくことで届く (まとめて流している途中ならBatchSubscriptionから下流にも伝わる)
+    // マップはObservableが生きている間保持される
+    // レコードの位置がTのアラインメントに合わない場合はstd::runtime_errorを投げる
+    template <typename T>
+    std::shared_ptr<Observable<T>> FromMappedFile(std::shared_ptr<const MappedFile> file,
+                                                  size_t offset = 0,
+                                                  size_t chunkSize = DefaultMappedChunkSize)
+    {
+        const auto records = file->As<T>(offset);
+        // 流している途中の購読をまとめて廃棄する用 (流し終えた購読は取り除く)
+        auto group = RxPool::MakeShared<CompositeDisposable>();
+
+        return RxPool::MakeShared<Observable<T>>(
+            [file, records, group, chunkSize](ObserverPtr<T> o) -> std::shared_ptr<Disposable>
+            {
+                auto subscription = RxPool::MakeShared<Disposable>();
+                group->Add(subscription);
+                AssignableDisposable::LinkPending(subscription);
+                AssignableDisposable::PendingScope detach(nullptr);
+
+                const auto* data = records.data();
+                const auto count = records.size();
+                if (chunkSize == 0)
+                {
+                    for (size_t i = 0; i < count && !subscription->IsDisposed(); ++i)
+                    {
+                        o->OnNext(data[i]);
+                    }
+                }
+                else
+                {
+                    BatchSubscription::Scope batch(subscription.get());
+                    for (size_t i = 0; i < count && !subscription->IsDisposed(); i += chunkSize)
+                    {
+                        o->OnNextBatch(data + i, count - i < chunkSize ? count - i : chunkSize);
+                    }
+                }
+
+                if (!subscription->IsDisposed()) o->OnCompleted();
+                group->Remove(subscription);
+                return subscription;
+            },
+            group,
+            nullptr
+        );
+    }
+
+    // pathのファイルを先頭から順に読む前提でマップする。開けない/マップできない場合はstd::runtime_errorを投げる
+    template <typename T>
+    std::shared_ptr<Observable<T>> FromMappedFile(const std::string& path,
+                                                  size_t offset = 0,
+                                                  size_t chunkSize = DefaultMappedChunkSize)
+    {
+        return FromMappedFile<T>(RxPool::MakeShared<MappedFile>(path, MappedFile::Access::Sequential), offset, chunkSize);
     }
 
     inline void DoEveryUpdate()
     {
+        // MainThreadSchedulerに積まれた処理を先に実行
+        std::static_pointer_cast<MainThreadScheduler>(Scheduler::MainThread())->Drain();
+
         everyUpdateSubject->OnNext(Unit());
+
+        // フレーム指定のタイマーはEveryUpdateの通知の後に発火させる
+        FrameTimerWheel::Main().Advance();
     }
 }
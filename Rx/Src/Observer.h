@@ -1,37 +1,139 @@
 #pragma once
-#include <functional>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "Disposable.h"
+#include "Function.h"
+#include "ObserverPtr.h"
+
+// OnNextBatchで配信中の購読 (Subject等が購読ごとに設定する)
+// まとめて受け取れないObserverへ1つずつ流す途中で購読が廃棄されたら、OnNextを繰り返した場合と同じく残りは流さない
+class BatchSubscription
+{
+    static const Disposable*& Current()
+    {
+        static thread_local const Disposable* current = nullptr;
+        return current;
+    }
+
+public:
+    // 配信中の購読が廃棄された
+    static bool IsCancelled()
+    {
+        const auto* d = Current();
+        return d != nullptr && d->IsDisposed();
+    }
+
+    // 配信の間だけ設定する (入れ子の配信から戻ったら元に戻す)
+    class Scope
+    {
+        const Disposable* saved;
+
+    public:
+        explicit Scope(const Disposable* subscription): saved(Current()) { Current() = subscription; }
+        ~Scope() { Current() = saved; }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+};
 
 template <typename T>
-class Observer
+class Observer : public ObserverBase
 {
 protected:
-    std::function<void(T)> _onNext;
-    std::function<void()> _onCompleted;
+    Function<void(const T&)> _onNext;
+    Function<void()> _onCompleted; // 完了時の処理が無ければ空
+    Function<void(const T*, size_t)> _onNextBatch; // 下流がまとめて受け取れる場合のみ設定される
     bool isStopped;
+    // 転送先のObserver (オペレータの転送処理は生ポインタで参照するので、ここで生かしておく)
+    DownstreamRef downstream;
+
+    // 下流へまとめて流す (まとめて受け取れない場合は1つずつ)
+    void NextBatch(const T* data, size_t n)
+    {
+        if (BatchSubscription::IsCancelled()) return;
+
+        if (_onNextBatch != nullptr)
+        {
+            _onNextBatch(data, n);
+            return;
+        }
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (BatchSubscription::IsCancelled()) return;
+            _onNext(data[i]);
+        }
+    }
 
 public:
-    explicit Observer(std::function<void(T)> onNext,
-                      std::function<void()> onCompleted)
+    explicit Observer(Function<void(const T&)> onNext,
+                      Function<void()> onCompleted,
+                      Function<void(const T*, size_t)> onNextBatch = nullptr)
         : _onNext(std::move(onNext)),
           _onCompleted(std::move(onCompleted)),
+          _onNextBatch(std::move(onNextBatch)),
           isStopped(false)
     {
     }
 
     virtual ~Observer() = default;
 
-    virtual void OnNext(T v)
+    void HoldDownstream(DownstreamRef o) { downstream = std::move(o); }
+
+    virtual void OnNext(const T& v)
     {
         if (this->isStopped) return;
 
         _onNext(v);
     }
 
+    // 連続した値をまとめて受け取る。既定では1つずつOnNextする
+    virtual void OnNextBatch(const T* data, size_t n)
+    {
+        if (this->isStopped) return;
+
+        if (_onNextBatch != nullptr)
+        {
+            _onNextBatch(data, n);
+            return;
+        }
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            // 途中で購読が廃棄されたら残りは流さない
+            if (BatchSubscription::IsCancelled()) return;
+            OnNext(data[i]);
+        }
+    }
+
     virtual void OnCompleted()
     {
         if (this->isStopped) return;
         
-        _onCompleted();
+        if (_onCompleted != nullptr) _onCompleted();
         isStopped = true;
     }
 };
+
+#if RX_SINGLE_THREADED
+// shared_ptrで渡されたObserverへ転送するObserver (Subscribe(std::shared_ptr<Observer<T>>)用)
+template <typename T>
+class SharedObserver : public Observer<T>
+{
+    std::shared_ptr<Observer<T>> inner;
+
+public:
+    explicit SharedObserver(std::shared_ptr<Observer<T>> inner)
+        : Observer<T>(nullptr, nullptr),
+          inner(std::move(inner))
+    {
+    }
+
+    void OnNext(const T& v) override { inner->OnNext(v); }
+    void OnNextBatch(const T* data, size_t n) override { inner->OnNextBatch(data, n); }
+    void OnCompleted() override { inner->OnCompleted(); }
+};
+#endif
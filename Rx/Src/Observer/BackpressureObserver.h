@@ -0,0 +1,176 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "../Disposable.h"
+#include "../Observer.h"
+#include "../RingBuffer.h"
+#include "../RxPool.h"
+#include "../Scheduler.h"
+
+// 背圧(OnBackpressure系)オペレータやZipで捨てた値の数 (監視用。購読をまたいで合算される)
+class BackpressureStats
+{
+    std::atomic<uint64_t> dropped{0};
+
+public:
+    void AddDropped(uint64_t n) { dropped.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t Dropped() const { return dropped.load(std::memory_order_relaxed); }
+};
+
+// 受け取った値を容量固定のキューに積み、指定のスケジューラ上で下流へ流すObserver
+// 下流が追いつかずキューが満杯になった場合は、指定の方針で値を捨てる
+// 1回の排出で流すのは容量分までなので、流し続けている間に積まれ続けても1回の処理時間は容量で抑えられる
+template <typename T>
+class BackpressureObserver : public Observer<T>
+{
+public:
+    // 満杯時の方針
+    enum class Overflow
+    {
+        DropNewest, // 受け取った値を捨てる
+        DropOldest, // 最も古い値を捨てて積む
+    };
+
+private:
+    struct Queue : std::enable_shared_from_this<Queue>
+    {
+        ObserverPtr<T> downstream;
+        std::shared_ptr<Scheduler> scheduler;
+        std::shared_ptr<Disposable> disposable;
+        std::shared_ptr<BackpressureStats> stats;
+        Overflow overflow;
+
+        std::mutex mutex;
+        RingBuffer<T> values;
+        RingBuffer<T> draining; // 排出処理のみが触る
+        bool completed = false;
+        bool scheduled = false;
+
+        explicit Queue(size_t capacity): values(capacity), draining(capacity)
+        {
+        }
+
+        void Drop()
+        {
+            if (stats != nullptr) stats->AddDropped(1);
+        }
+
+        void Push(const T& v)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (completed) return;
+
+                if (values.Full() && overflow == Overflow::DropNewest)
+                {
+                    Drop();
+                    return;
+                }
+                if (values.PushBack(v)) Drop();
+
+                if (scheduled) return;
+                scheduled = true;
+            }
+
+            Schedule();
+        }
+
+        void Complete()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                completed = true;
+
+                if (scheduled) return;
+                scheduled = true;
+            }
+
+            Schedule();
+        }
+
+        void Schedule()
+        {
+            // 排出処理の実行中は自身を生かしておく
+            auto self = this->shared_from_this();
+            scheduler->Schedule([self] { self->Drain(); });
+        }
+
+        void Drain()
+        {
+            {
+                // 今回流す分を排出側のバッファへ移す (最大で容量分)
+                // 排出中も上流は積み続けられ、DropOldestでも排出中の値は上書きされない
+                std::lock_guard<std::mutex> lock(mutex);
+                while (!values.Empty())
+                {
+                    draining.PushBack(std::move(values.Front()));
+                    values.PopFront();
+                }
+            }
+
+            while (!draining.Empty())
+            {
+                // 廃棄後に届いたものは捨てる
+                if (disposable == nullptr || !disposable->IsDisposed()) downstream->OnNext(draining.Front());
+                draining.PopFront();
+            }
+
+            bool more = false;
+            bool complete = false;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                more = !values.Empty();
+                complete = completed; // 排出中に完了した場合もここで拾う
+                // 完了後はscheduledを立てたままにして、以降の排出を止める
+                if (!more && !complete) scheduled = false;
+            }
+
+            if (more)
+            {
+                // 排出中に積まれた分は次回へ回す
+                Schedule();
+                return;
+            }
+            if (!complete) return;
+
+            if (disposable == nullptr || !disposable->IsDisposed()) downstream->OnCompleted();
+        }
+    };
+
+    std::shared_ptr<Queue> queue;
+
+public:
+    BackpressureObserver(ObserverPtr<T> downstream,
+                         std::shared_ptr<Scheduler> scheduler,
+                         std::shared_ptr<Disposable> disposable,
+                         size_t capacity,
+                         Overflow overflow,
+                         std::shared_ptr<BackpressureStats> stats)
+        : Observer<T>(nullptr, nullptr),
+          queue(RxPool::MakeShared<Queue>(capacity))
+    {
+        queue->downstream = std::move(downstream);
+        queue->scheduler = std::move(scheduler);
+        queue->disposable = std::move(disposable);
+        queue->overflow = overflow;
+        queue->stats = std::move(stats);
+    }
+
+    void OnNext(const T& v) override
+    {
+        if (this->isStopped) return;
+
+        queue->Push(v);
+    }
+
+    void OnCompleted() override
+    {
+        if (this->isStopped) return;
+
+        queue->Complete();
+        this->isStopped = true;
+    }
+};
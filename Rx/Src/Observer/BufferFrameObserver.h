@@ -0,0 +1,84 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "../Disposable.h"
+#include "../FrameTimerWheel.h"
+#include "../Observer.h"
+#include "../Span.h"
+
+// 指定フレームの間に受け取った値をまとめて流すObserver (フレームはObservableUtil::DoEveryUpdateで進む)
+// 何も受け取らなかったフレームでは流さない
+// 溜める領域は2つを交互に使い回すので、流している最中に値を受け取っても参照先は壊れない
+template <typename T>
+class BufferFrameObserver : public Observer<T>
+{
+    struct State
+    {
+        ObserverPtr<Span<T>> downstream;
+        std::shared_ptr<Disposable> disposable;
+        std::vector<T> values;
+        std::vector<T> flushing;
+
+        void Flush()
+        {
+            if (values.empty()) return;
+
+            std::swap(values, flushing);
+            if (!disposable->IsDisposed()) downstream->OnNext(Span<T>(flushing.data(), flushing.size()));
+            flushing.clear();
+        }
+    };
+
+    std::shared_ptr<State> state;
+    std::shared_ptr<FrameTimerWheel::Timer> timer;
+
+public:
+    BufferFrameObserver(ObserverPtr<Span<T>> downstream,
+                        int frames,
+                        std::shared_ptr<Disposable> disposable)
+        : Observer<T>(nullptr, nullptr),
+          state(RxPool::MakeShared<State>())
+    {
+        state->downstream = std::move(downstream);
+        state->disposable = std::move(disposable);
+
+        const auto period = static_cast<uint32_t>(frames > 0 ? frames : 1);
+        std::weak_ptr<State> weakState = state;
+        timer = FrameTimerWheel::Main().Schedule(period, [weakState]
+        {
+            if (auto s = weakState.lock()) s->Flush();
+        }, period);
+    }
+
+    ~BufferFrameObserver() override
+    {
+        timer->Dispose();
+    }
+
+    void OnNext(const T& v) override
+    {
+        if (this->isStopped) return;
+
+        state->values.push_back(v);
+    }
+
+    void OnNextBatch(const T* data, size_t n) override
+    {
+        if (this->isStopped) return;
+
+        state->values.insert(state->values.end(), data, data + n);
+    }
+
+    // 完了時は溜まっている分を流してから完了する
+    void OnCompleted() override
+    {
+        if (this->isStopped) return;
+
+        this->isStopped = true;
+        timer->Dispose();
+
+        state->Flush();
+        state->downstream->OnCompleted();
+    }
+};
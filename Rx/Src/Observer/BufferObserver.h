@@ -0,0 +1,117 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "../Observer.h"
+#include "../Span.h"
+
+// count個ずつまとめて流すObserver (skip個ごとに新しいまとまりを始める)
+// まとめる領域は購読時に確保したものを使い回し、下流にはその領域を指すSpanを渡す
+template <typename T>
+class BufferObserver : public Observer<T>
+{
+    ObserverPtr<Span<T>> downstream;
+    size_t count;
+    size_t skip;
+
+    // 先頭startからが現在のまとまり。重なりがある(skip < count)場合は末尾まで使い切った時だけ先頭へ詰める
+    std::vector<T> storage;
+    size_t start;
+    size_t skipRemain; // skip > countの場合に読み飛ばす残り数
+
+    void Push(const T& v)
+    {
+        if (skipRemain > 0)
+        {
+            --skipRemain;
+            return;
+        }
+
+        // 容量を2count確保しているので、詰め直しはcount個ごとに高々1回 (償却O(1))
+        if (storage.size() == storage.capacity())
+        {
+            storage.erase(storage.begin(), storage.begin() + static_cast<std::ptrdiff_t>(start));
+            start = 0;
+        }
+
+        storage.push_back(v);
+        if (storage.size() - start < count) return;
+
+        downstream->OnNext(Span<T>(storage.data() + start, count));
+        Advance();
+    }
+
+    // 1つのまとまりを流し終えた後、次のまとまりの開始位置へ進める
+    void Advance()
+    {
+        if (skip >= count)
+        {
+            storage.clear();
+            start = 0;
+            skipRemain = skip - count;
+            return;
+        }
+
+        start += skip;
+    }
+
+public:
+    BufferObserver(ObserverPtr<Span<T>> downstream, int count, int skip)
+        : Observer<T>(nullptr, nullptr),
+          downstream(std::move(downstream)),
+          count(count > 0 ? static_cast<size_t>(count) : 1),
+          skip(skip > 0 ? static_cast<size_t>(skip) : 1),
+          start(0),
+          skipRemain(0)
+    {
+        storage.reserve(this->count * 2);
+    }
+
+    void OnNext(const T& v) override
+    {
+        if (this->isStopped) return;
+
+        Push(v);
+    }
+
+    void OnNextBatch(const T* data, size_t n) override
+    {
+        if (this->isStopped) return;
+
+        size_t i = 0;
+        while (i < n && !BatchSubscription::IsCancelled())
+        {
+            // 重なりがなく溜まっている分もない場合は、コピーせず入力をそのまま区切って流す
+            if (skip >= count && storage.empty() && skipRemain == 0 && n - i >= count)
+            {
+                downstream->OnNext(Span<T>(data + i, count));
+                i += count;
+
+                const auto rest = n - i;
+                const auto skipNow = skip - count < rest ? skip - count : rest;
+                i += skipNow;
+                skipRemain = skip - count - skipNow;
+                continue;
+            }
+
+            Push(data[i++]);
+        }
+    }
+
+    // 完了時は溜まっている途中のまとまりも流す
+    void OnCompleted() override
+    {
+        if (this->isStopped) return;
+
+        for (auto s = start; s < storage.size(); s += skip)
+        {
+            downstream->OnNext(Span<T>(storage.data() + s, storage.size() - s));
+            if (skip >= count) break;
+        }
+        storage.clear();
+        start = 0;
+
+        downstream->OnCompleted();
+        this->isStopped = true;
+    }
+};
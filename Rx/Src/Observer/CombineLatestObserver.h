@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <tuple>
+
+#include "../Observer.h"
+
+// 各入力の最新の値を1つのtupleにまとめて持ち、いずれかの入力が値を受け取るたびにそのtupleを流す
+// 全ての入力が1度は値を受け取るまでは流さない
+// tupleは購読ごとに1つだけ確保し、値ごとには確保しない (そのため各値の型は既定コンストラクタを持つこと)
+// 全ての入力が完了するか、値を1度も受け取らずに完了した入力があれば完了する
+// 注意: スレッドセーフではない (入力は同じスレッドから流すこと)
+template <typename... Ts>
+struct CombineLatestState
+{
+    static constexpr size_t Count = sizeof...(Ts);
+
+    ObserverPtr<std::tuple<Ts...>> downstream;
+    std::tuple<Ts...> latest;
+    bool has[Count] = {};
+    size_t filled = 0; // 値を受け取ったことのある入力の数
+    size_t completed = 0;
+    bool done = false;
+
+    template <size_t I, typename V>
+    void Next(const V& v)
+    {
+        if (done) return;
+
+        std::get<I>(latest) = v;
+        if (!has[I])
+        {
+            has[I] = true;
+            ++filled;
+        }
+
+        if (filled == Count) downstream->OnNext(latest);
+    }
+
+    void Completed(size_t index)
+    {
+        if (done) return;
+
+        ++completed;
+        if (completed == Count || !has[index])
+        {
+            done = true;
+            downstream->OnCompleted();
+        }
+    }
+};
+
+// CombineLatestのI番目の入力
+template <size_t I, typename... Ts>
+class CombineLatestObserver : public Observer<typename std::tuple_element<I, std::tuple<Ts...>>::type>
+{
+    using T = typename std::tuple_element<I, std::tuple<Ts...>>::type;
+
+    std::shared_ptr<CombineLatestState<Ts...>> state;
+
+public:
+    explicit CombineLatestObserver(std::shared_ptr<CombineLatestState<Ts...>> state)
+        : Observer<T>(nullptr, nullptr),
+          state(std::move(state))
+    {
+    }
+
+    void OnNext(const T& v) override
+    {
+        if (this->isStopped) return;
+
+        state->template Next<I>(v);
+    }
+
+    void OnCompleted() override
+    {
+        if (this->isStopped) return;
+
+        this->isStopped = true;
+        state->Completed(I);
+    }
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "../Disposable.h"
+#include "../FrameTimerWheel.h"
+#include "../Observer.h"
+
+// 受け取った値を指定フレーム後に下流へ流すObserver
+// 値ごとにFrameTimerWheelへ登録するので、待機中の値が多くても毎フレームのコストは発火する分だけ
+template <typename T>
+class DelayFrameObserver : public Observer<T>
+{
+    ObserverPtr<T> downstream;
+    uint32_t delayFrame;
+    std::shared_ptr<Disposable> disposable;
+
+public:
+    DelayFrameObserver(ObserverPtr<T> downstream,
+                       int delayFrame,
+                       std::shared_ptr<Disposable> disposable)
+        : Observer<T>(nullptr, nullptr),
+          downstream(std::move(downstream)),
+          delayFrame(delayFrame > 0 ? static_cast<uint32_t>(delayFrame) : 1),
+          disposable(std::move(disposable))
+    {
+    }
+
+    void OnNext(const T& v) override
+    {
+        if (this->isStopped) return;
+
+        auto o = downstream;
+        auto d = disposable;
+        FrameTimerWheel::Main().Schedule(delayFrame, [o, d, v]
+        {
+            // 待っている間に廃棄されたものは捨てる
+            if (!d->IsDisposed()) o->OnNext(v);
+        });
+    }
+
+    // バッチはまとめて1つのタイマーで遅らせる
+    void OnNextBatch(const T* data, size_t n) override
+    {
+        if (this->isStopped || n == 0) return;
+
+        auto o = downstream;
+        auto d = disposable;
+        auto values = std::make_shared<std::vector<T>>(data, data + n);
+        FrameTimerWheel::Main().Schedule(delayFrame, [o, d, values]
+        {
+            if (!d->IsDisposed()) o->OnNextBatch(values->data(), values->size());
+        });
+    }
+
+    void OnCompleted() override
+    {
+        if (this->isStopped) return;
+
+        this->isStopped = true;
+
+        auto o = downstream;
+        auto d = disposable;
+        FrameTimerWheel::Main().Schedule(delayFrame, [o, d]
+        {
+            if (!d->IsDisposed()) o->OnCompleted();
+        });
+    }
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "../Observer.h"
+
+// 直前の値とキーが同じ値を捨てるObserver
+// 直前のキーは自身の中に持つので、値ごとの確保はしない (キーの型がヒープを使う場合を除く)
+// comparerを指定しない場合はキーを==で比べる
+template <typename T, typename Key>
+class DistinctUntilChangedObserver : public Observer<T>
+{
+    using Storage = typename std::aligned_storage<sizeof(Key), alignof(Key)>::type;
+
+    Function<Key(const T&)> keySelector;
+    Function<bool(const Key&, const Key&)> comparer;
+    Storage lastStorage;
+    bool hasLast;
+
+    Key& Last() { return *reinterpret_cast<Key*>(&lastStorage); }
+
+    // 直前と異なれば記録してtrueを返す
+    bool Changed(const T& v)
+    {
+        auto key = keySelector(v);
+        if (hasLast)
+        {
+            const auto same = comparer != nullptr ? comparer(Last(), key) : Last() == key;
+            if (same) return false;
+
+            Last() = std::move(key);
+            return true;
+        }
+
+        new(&lastStorage) Key(std::move(key));
+        hasLast = true;
+        return true;
+    }
+
+public:
+    DistinctUntilChangedObserver(Function<void(const T&)> onNext,
+                                 Function<void()> onCompleted,
+                                 Function<Key(const T&)> keySelector,
+                                 Function<bool(const Key&, const Key&)> comparer,
+                                 Function<void(const T*, size_t)> onNextBatch = nullptr)
+        : Observer<T>(std::move(onNext), std::move(onCompleted), std::move(onNextBatch)),
+          keySelector(std::move(keySelector)),
+          comparer(std::move(comparer)),
+          hasLast(false)
+    {
+    }
+
+    ~DistinctUntilChangedObserver() override
+    {
+        if (hasLast) Last().~Key();
+    }
+
+    DistinctUntilChangedObserver(const DistinctUntilChangedObserver&) = delete;
+    DistinctUntilChangedObserver& operator=(const DistinctUntilChangedObserver&) = delete;
+
+    void OnNext(const T& v) override
+    {
+        if (this->isStopped) return;
+
+        if (Changed(v)) this->_onNext(v);
+    }
+
+    // 変化した値が連続する区間ごとに元の配列のまま流す
+    void OnNextBatch(const T* data, size_t n) override
+    {
+        if (this->isStopped) return;
+
+        size_t i = 0;
+        while (i < n)
+        {
+            while (i < n && !Changed(data[i])) ++i;
+
+            const auto begin = i;
+            if (i < n) ++i; // Changedで記録済み
+            while (i < n && Changed(data[i])) ++i;
+
+            if (i > begin) this->NextBatch(data + begin, i - begin);
+        }
+    }
+};
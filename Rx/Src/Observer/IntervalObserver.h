@@ -1,4 +1,7 @@
 ﻿#pragma once
+#include <type_traits>
+#include <vector>
+
 #include "../Observer.h"
 
 template <typename T>
@@ -6,18 +9,50 @@ class IntervalObserver : public Observer<T>
 {
     int counter;
     int intervalCount;
+    std::vector<T> scratch; // バッチ時に間引いた値を詰める作業領域 (使い回す)
+    bool inBatch;
+
+    // 間引いた値を詰め直してまとめて流す
+    void NextBatchStrided(const T* data, size_t n, std::true_type)
+    {
+        scratch.clear();
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (counter++ < intervalCount - 1) continue;
+
+            counter = 0;
+            scratch.push_back(data[i]);
+        }
+
+        if (!scratch.empty()) this->NextBatch(scratch.data(), scratch.size());
+    }
+
+    // コピーが重い型は詰め直さず1つずつ流す
+    void NextBatchStrided(const T* data, size_t n, std::false_type)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (counter++ < intervalCount - 1) continue;
+            if (BatchSubscription::IsCancelled()) return;
+
+            counter = 0;
+            this->_onNext(data[i]);
+        }
+    }
 
 public:
-    explicit IntervalObserver(std::function<void(T)> onNext,
-                              std::function<void()> onCompleted,
-                              int skipCount)
-        : Observer<T>(onNext, onCompleted),
+    explicit IntervalObserver(Function<void(const T&)> onNext,
+                              Function<void()> onCompleted,
+                              int skipCount,
+                              Function<void(const T*, size_t)> onNextBatch = nullptr)
+        : Observer<T>(std::move(onNext), std::move(onCompleted), std::move(onNextBatch)),
           counter(0),
-          intervalCount(skipCount)
+          intervalCount(skipCount),
+          inBatch(false)
     {
     }
 
-    void OnNext(T v) override
+    void OnNext(const T& v) override
     {
         if (this->isStopped) return;
 
@@ -26,4 +61,20 @@ public:
         counter = 0;
         this->_onNext(v);
     }
+
+    void OnNextBatch(const T* data, size_t n) override
+    {
+        if (this->isStopped) return;
+
+        // 下流から再入された場合は作業領域が使用中なので1つずつ流す
+        if (inBatch)
+        {
+            NextBatchStrided(data, n, std::false_type());
+            return;
+        }
+
+        inBatch = true;
+        NextBatchStrided(data, n, std::integral_constant<bool, std::is_trivially_copyable<T>::value>());
+        inBatch = false;
+    }
 };
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+
+#include "../Observer.h"
+
+// 複数の入力の値をそのまま下流へ流すObserver (入力ごとに1つ作り、状態は購読ごとに1つを共有する)
+// 全ての入力が完了したら完了する
+// 注意: スレッドセーフではない (入力は同じスレッドから流すこと)
+template <typename T>
+class MergeObserver : public Observer<T>
+{
+public:
+    struct State
+    {
+        ObserverPtr<T> downstream;
+        size_t remaining = 0; // 完了していない入力の数
+    };
+
+private:
+    std::shared_ptr<State> state;
+
+public:
+    explicit MergeObserver(std::shared_ptr<State> state)
+        : Observer<T>(nullptr, nullptr),
+          state(std::move(state))
+    {
+    }
+
+    void OnNext(const T& v) override
+    {
+        if (this->isStopped) return;
+
+        state->downstream->OnNext(v);
+    }
+
+    void OnNextBatch(const T* data, size_t n) override
+    {
+        if (this->isStopped) return;
+
+        state->downstream->OnNextBatch(data, n);
+    }
+
+    void OnCompleted() override
+    {
+        if (this->isStopped) return;
+
+        this->isStopped = true;
+        if (--state->remaining == 0) state->downstream->OnCompleted();
+    }
+};
@@ -0,0 +1,112 @@
+#pragma once
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "../Disposable.h"
+#include "../Observer.h"
+#include "../Scheduler.h"
+
+// 受け取った値を指定のスケジューラ上で下流へ流すObserver
+// 値は購読ごとのキューに積み、同時に1つの排出処理だけをスケジュールするので、順序は保たれる
+template <typename T>
+class ObserveOnObserver : public Observer<T>
+{
+    struct Queue : std::enable_shared_from_this<Queue>
+    {
+        ObserverPtr<T> downstream;
+        std::shared_ptr<Scheduler> scheduler;
+        std::shared_ptr<Disposable> disposable;
+
+        std::mutex mutex;
+        std::deque<T> values;
+        bool completed = false;
+        bool scheduled = false;
+
+        void Push(const T* v)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (v != nullptr) values.push_back(*v);
+                else completed = true;
+
+                if (scheduled) return;
+                scheduled = true;
+            }
+
+            // 排出処理の実行中は自身を生かしておく
+            auto self = this->shared_from_this();
+            scheduler->Schedule([self] { self->Drain(); });
+        }
+
+        void Drain()
+        {
+            while (true)
+            {
+                T* value = nullptr;
+                bool complete = false;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (values.empty())
+                    {
+                        complete = completed;
+                        completed = false;
+                        if (!complete)
+                        {
+                            scheduled = false;
+                            return;
+                        }
+                    }
+                    else
+                    {
+                        value = &values.front();
+                    }
+                }
+
+                // 廃棄後に届いたものは捨てる
+                const auto disposed = disposable != nullptr && disposable->IsDisposed();
+
+                if (complete)
+                {
+                    if (!disposed) downstream->OnCompleted();
+                    continue;
+                }
+
+                // 先頭要素は排出側しか取り出さないので、ロック外で参照してよい
+                if (!disposed) downstream->OnNext(*value);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                values.pop_front();
+            }
+        }
+    };
+
+    std::shared_ptr<Queue> queue;
+
+public:
+    ObserveOnObserver(ObserverPtr<T> downstream,
+                      std::shared_ptr<Scheduler> scheduler,
+                      std::shared_ptr<Disposable> disposable)
+        : Observer<T>(nullptr, nullptr),
+          queue(RxPool::MakeShared<Queue>())
+    {
+        queue->downstream = std::move(downstream);
+        queue->scheduler = std::move(scheduler);
+        queue->disposable = std::move(disposable);
+    }
+
+    void OnNext(const T& v) override
+    {
+        if (this->isStopped) return;
+
+        queue->Push(&v);
+    }
+
+    void OnCompleted() override
+    {
+        if (this->isStopped) return;
+
+        queue->Push(nullptr);
+        this->isStopped = true;
+    }
+};
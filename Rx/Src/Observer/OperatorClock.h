@@ -0,0 +1,34 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+#include "../FrameTimerWheel.h"
+
+// 時間を扱うオペレータ(Throttle/Sampleなど)の時計
+// Nowで現在時刻を、FramesForで残り時間が経つまでに待つフレーム数を返す
+
+// フレーム数で測る時計 (フレームはObservableUtil::DoEveryUpdateで進む)
+struct FrameClock
+{
+    using TimePoint = uint64_t;
+    using Duration = uint64_t;
+
+    static TimePoint Now() { return FrameTimerWheel::Main().Frame(); }
+
+    static uint32_t FramesFor(Duration remaining)
+    {
+        return static_cast<uint32_t>(remaining > 0 ? remaining : 1);
+    }
+};
+
+// 実時間で測る時計
+// 実時間はフレームと対応しないので、待つ間は毎フレーム確かめる
+struct SteadyClock
+{
+    using TimePoint = std::chrono::steady_clock::time_point;
+    using Duration = std::chrono::steady_clock::duration;
+
+    static TimePoint Now() { return std::chrono::steady_clock::now(); }
+
+    static uint32_t FramesFor(Duration) { return 1; }
+};
@@ -0,0 +1,48 @@
+#pragma once
+#include <memory>
+
+#include "../EventLog.h"
+#include "../FrameTimerWheel.h"
+#include "../Observer.h"
+
+// 流れた値をそのまま下流へ流しつつ、フレーム番号付きでログへ積む
+template <typename T>
+class RecordObserver : public Observer<T>
+{
+    std::shared_ptr<EventLogWriter> writer;
+
+public:
+    explicit RecordObserver(Function<void(const T&)> onNext,
+                            Function<void()> onCompleted,
+                            std::shared_ptr<EventLogWriter> writer,
+                            Function<void(const T*, size_t)> onNextBatch = nullptr)
+        : Observer<T>(std::move(onNext), std::move(onCompleted), std::move(onNextBatch)),
+          writer(std::move(writer))
+    {
+    }
+
+    void OnNext(const T& v) override
+    {
+        if (this->isStopped) return;
+
+        writer->Append(FrameTimerWheel::Main().Frame(), &v, 1);
+        this->_onNext(v);
+    }
+
+    void OnNextBatch(const T* data, size_t n) override
+    {
+        if (this->isStopped) return;
+
+        writer->Append(FrameTimerWheel::Main().Frame(), data, n);
+        this->NextBatch(data, n);
+    }
+
+    void OnCompleted() override
+    {
+        if (this->isStopped) return;
+
+        // 完了したら積んでいるものを書き出しておく
+        writer->Flush();
+        Observer<T>::OnCompleted();
+    }
+};
@@ -0,0 +1,88 @@
+#pragma once
+#include <memory>
+
+#include "../Disposable.h"
+#include "../FrameTimerWheel.h"
+#include "../Observer.h"
+#include "../RingBuffer.h"
+#include "../RxPool.h"
+
+// interval(Clockで測る)ごとに、その間に受け取った最新の値を流すObserver
+// 何も受け取らなかった区間では流さない。タイマーは購読ごとに周期タイマー1つだけ
+// 注意: フレームで進むので、ObservableUtil::DoEveryUpdateと同じスレッドで使うこと
+template <typename T, typename Clock>
+class SampleObserver : public Observer<T>
+{
+    struct State
+    {
+        ObserverPtr<T> downstream;
+        std::shared_ptr<Disposable> disposable;
+        typename Clock::Duration interval;
+        typename Clock::TimePoint tick{};
+        RingBuffer<T> latest{1};
+
+        void OnTimer()
+        {
+            const auto now = Clock::Now();
+            if (now - tick < interval) return;
+
+            tick = now;
+            Flush();
+        }
+
+        void Flush()
+        {
+            if (latest.Empty()) return;
+
+            if (disposable == nullptr || !disposable->IsDisposed()) downstream->OnNext(latest.Front());
+            latest.PopFront();
+        }
+    };
+
+    std::shared_ptr<State> state;
+    std::shared_ptr<FrameTimerWheel::Timer> timer;
+
+public:
+    SampleObserver(ObserverPtr<T> downstream,
+                   typename Clock::Duration interval,
+                   std::shared_ptr<Disposable> disposable)
+        : Observer<T>(nullptr, nullptr),
+          state(RxPool::MakeShared<State>())
+    {
+        state->downstream = std::move(downstream);
+        state->disposable = std::move(disposable);
+        state->interval = interval;
+        state->tick = Clock::Now();
+
+        const auto period = Clock::FramesFor(interval);
+        std::weak_ptr<State> weakState = state;
+        timer = FrameTimerWheel::Main().Schedule(period, [weakState]
+        {
+            if (auto s = weakState.lock()) s->OnTimer();
+        }, period);
+    }
+
+    ~SampleObserver() override
+    {
+        timer->Dispose();
+    }
+
+    void OnNext(const T& v) override
+    {
+        if (this->isStopped) return;
+
+        state->latest.PushBack(v);
+    }
+
+    // 完了時は未送出の値を流してから完了する
+    void OnCompleted() override
+    {
+        if (this->isStopped) return;
+
+        this->isStopped = true;
+        timer->Dispose();
+
+        state->Flush();
+        state->downstream->OnCompleted();
+    }
+};
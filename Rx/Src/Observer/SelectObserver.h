@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+
+#include "../Observer.h"
+
+template <typename T, typename Ret>
+class SelectObserver : public Observer<T>
+{
+    Function<Ret(const T&)> select;
+    Function<void(const Ret&)> onNextSelected;
+    Function<void(const Ret*, size_t)> onNextSelectedBatch;
+    std::vector<Ret> scratch; // バッチ時に変換結果を詰める作業領域 (使い回す)
+    bool inBatch;
+
+public:
+    explicit SelectObserver(Function<void(const Ret&)> onNext,
+                            Function<void()> onCompleted,
+                            Function<Ret(const T&)> select,
+                            Function<void(const Ret*, size_t)> onNextBatch = nullptr)
+        : Observer<T>(nullptr, std::move(onCompleted)),
+          select(std::move(select)),
+          onNextSelected(std::move(onNext)),
+          onNextSelectedBatch(std::move(onNextBatch)),
+          inBatch(false)
+    {
+    }
+
+    void OnNext(const T& v) override
+    {
+        if (this->isStopped) return;
+
+        onNextSelected(select(v));
+    }
+
+    void OnNextBatch(const T* data, size_t n) override
+    {
+        if (this->isStopped) return;
+
+        // まとめて受け取れない下流、または再入時は1つずつ流す
+        if (onNextSelectedBatch == nullptr || inBatch)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                onNextSelected(select(data[i]));
+            }
+            return;
+        }
+
+        inBatch = true;
+        scratch.clear();
+        scratch.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            scratch.push_back(select(data[i]));
+        }
+        onNextSelectedBatch(scratch.data(), scratch.size());
+        inBatch = false;
+    }
+};
@@ -8,16 +8,17 @@ class SkipObserver : public Observer<T>
     int skipCount;
 
 public:
-    explicit SkipObserver(std::function<void(T)> onNext,
-                          std::function<void()> onCompleted,
-                          int skipCount)
-        : Observer<T>(onNext, onCompleted),
+    explicit SkipObserver(Function<void(const T&)> onNext,
+                          Function<void()> onCompleted,
+                          int skipCount,
+                          Function<void(const T*, size_t)> onNextBatch = nullptr)
+        : Observer<T>(std::move(onNext), std::move(onCompleted), std::move(onNextBatch)),
           counter(0),
           skipCount(skipCount)
     {
     }
 
-    void OnNext(T v) override
+    void OnNext(const T& v) override
     {
         if (this->isStopped) return;
 
@@ -25,4 +26,19 @@ public:
 
         this->_onNext(v);
     }
+
+    void OnNextBatch(const T* data, size_t n) override
+    {
+        if (this->isStopped) return;
+
+        // 残りのスキップ数分だけ先頭を読み飛ばす
+        size_t skip = 0;
+        while (skip < n && counter < skipCount)
+        {
+            ++skip;
+            ++counter;
+        }
+
+        if (skip < n) this->NextBatch(data + skip, n - skip);
+    }
 };
@@ -9,18 +9,19 @@ class TakeObserver : public Observer<T>
     std::shared_ptr<Disposable> disposable;
 
 public:
-    explicit TakeObserver(std::function<void(T)> onNext,
-                          std::function<void()> onCompleted,
+    explicit TakeObserver(Function<void(const T&)> onNext,
+                          Function<void()> onCompleted,
                           int takeCount,
-                          std::shared_ptr<Disposable> disposable)
-        : Observer<T>(onNext, onCompleted),
+                          std::shared_ptr<Disposable> disposable,
+                          Function<void(const T*, size_t)> onNextBatch = nullptr)
+        : Observer<T>(std::move(onNext), std::move(onCompleted), std::move(onNextBatch)),
           counter(0),
           takeCount(takeCount),
           disposable(disposable)
     {
     }
 
-    void OnNext(T v) override
+    void OnNext(const T& v) override
     {
         if (this->isStopped) return;
 
@@ -28,6 +29,31 @@ public:
 
         if (++counter >= takeCount)
         {
+            // 購読中の同期的な通知(ReplaySubjectの再生など)で、上流の購読が決まる前に届く残りも止める
+            this->isStopped = true;
+            if (this->_onCompleted != nullptr) this->_onCompleted();
+
+            disposable->Dispose();
+        }
+    }
+
+    void OnNextBatch(const T* data, size_t n) override
+    {
+        // OnNextと同じく、回数が0以下でも最初の1つは流す
+        const int limit = takeCount > 0 ? takeCount : 1;
+        if (this->isStopped || counter >= limit) return;
+
+        // 残りの回数分だけ先頭から流す
+        const auto remain = static_cast<size_t>(limit - counter);
+        const auto take = n < remain ? n : remain;
+        if (take == 0) return;
+
+        this->NextBatch(data, take);
+        counter += static_cast<int>(take);
+
+        if (counter >= limit)
+        {
+            this->isStopped = true;
             if (this->_onCompleted != nullptr) this->_onCompleted();
 
             disposable->Dispose();
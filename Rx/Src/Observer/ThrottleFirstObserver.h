@@ -0,0 +1,43 @@
+#pragma once
+#include <memory>
+
+#include "../Observer.h"
+
+// 値を流したら、その後interval(Clockで測る)の間に受け取った値は捨てるObserver
+// タイマーは使わず、受け取った時点の時刻で判断する
+template <typename T, typename Clock>
+class ThrottleFirstObserver : public Observer<T>
+{
+    ObserverPtr<T> downstream;
+    typename Clock::Duration interval;
+    typename Clock::TimePoint last{};
+    bool emitted = false;
+
+public:
+    ThrottleFirstObserver(ObserverPtr<T> downstream, typename Clock::Duration interval)
+        : Observer<T>(nullptr, nullptr),
+          downstream(std::move(downstream)),
+          interval(interval)
+    {
+    }
+
+    void OnNext(const T& v) override
+    {
+        if (this->isStopped) return;
+
+        const auto now = Clock::Now();
+        if (emitted && now - last < interval) return;
+
+        emitted = true;
+        last = now;
+        downstream->OnNext(v);
+    }
+
+    void OnCompleted() override
+    {
+        if (this->isStopped) return;
+
+        downstream->OnCompleted();
+        this->isStopped = true;
+    }
+};
@@ -0,0 +1,101 @@
+#pragma once
+#include <memory>
+
+#include "../Disposable.h"
+#include "../FrameTimerWheel.h"
+#include "../Observer.h"
+#include "../RingBuffer.h"
+#include "../RxPool.h"
+
+// 最後に値を受け取ってからdue(Clockで測る)の間、次の値が来なかったら最後の値を流すObserver (Debounce)
+// 待ち合わせ用のタイマーは購読ごとに高々1つで、値を受け取るたびに作り直さない
+// 発火時にまだ期限が来ていなければ(途中で値を受け取っていれば)残りの分だけ待ち直す
+// 注意: フレームで進むので、ObservableUtil::DoEveryUpdateと同じスレッドで使うこと
+template <typename T, typename Clock>
+class ThrottleObserver : public Observer<T>
+{
+    struct State
+    {
+        ObserverPtr<T> downstream;
+        std::shared_ptr<Disposable> disposable;
+        typename Clock::Duration due;
+        typename Clock::TimePoint last{};
+        RingBuffer<T> latest{1};
+        std::shared_ptr<FrameTimerWheel::Timer> timer;
+
+        void Wait(typename Clock::Duration remaining, const std::shared_ptr<State>& self)
+        {
+            std::weak_ptr<State> weakState = self;
+            timer = FrameTimerWheel::Main().Schedule(Clock::FramesFor(remaining), [weakState]
+            {
+                if (auto s = weakState.lock()) s->OnTimer(s);
+            });
+        }
+
+        void OnTimer(const std::shared_ptr<State>& self)
+        {
+            timer = nullptr;
+
+            const auto elapsed = Clock::Now() - last;
+            if (elapsed < due)
+            {
+                Wait(due - elapsed, self);
+                return;
+            }
+
+            Flush();
+        }
+
+        void Flush()
+        {
+            if (latest.Empty()) return;
+
+            if (disposable == nullptr || !disposable->IsDisposed()) downstream->OnNext(latest.Front());
+            latest.PopFront();
+        }
+    };
+
+    std::shared_ptr<State> state;
+
+public:
+    ThrottleObserver(ObserverPtr<T> downstream,
+                     typename Clock::Duration due,
+                     std::shared_ptr<Disposable> disposable)
+        : Observer<T>(nullptr, nullptr),
+          state(RxPool::MakeShared<State>())
+    {
+        state->downstream = std::move(downstream);
+        state->disposable = std::move(disposable);
+        state->due = due;
+    }
+
+    ~ThrottleObserver() override
+    {
+        if (state->timer != nullptr) state->timer->Dispose();
+    }
+
+    void OnNext(const T& v) override
+    {
+        if (this->isStopped) return;
+
+        state->latest.PushBack(v);
+        state->last = Clock::Now();
+        if (state->timer == nullptr) state->Wait(state->due, state);
+    }
+
+    // 完了時は待っている値を流してから完了する
+    void OnCompleted() override
+    {
+        if (this->isStopped) return;
+
+        this->isStopped = true;
+        if (state->timer != nullptr)
+        {
+            state->timer->Dispose();
+            state->timer = nullptr;
+        }
+
+        state->Flush();
+        state->downstream->OnCompleted();
+    }
+};
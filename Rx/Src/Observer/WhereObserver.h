@@ -0,0 +1,77 @@
+#pragma once
+#include <type_traits>
+#include <vector>
+
+#include "../Observer.h"
+
+template <typename T>
+class WhereObserver : public Observer<T>
+{
+    Function<bool(const T&)> where;
+    std::vector<T> scratch; // バッチ時に条件を満たした値を詰める作業領域 (使い回す)
+    bool inBatch;
+
+    // 条件を満たした値を分岐なしで詰め直してまとめて流す
+    void NextBatchFiltered(const T* data, size_t n, std::true_type)
+    {
+        scratch.resize(n);
+        size_t count = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            scratch[count] = data[i];
+            count += where(data[i]) ? 1 : 0;
+        }
+
+        if (count > 0) this->NextBatch(scratch.data(), count);
+    }
+
+    // コピーが重い型は詰め直さず、条件を満たす連続区間ごとに元の配列のまま流す
+    void NextBatchFiltered(const T* data, size_t n, std::false_type)
+    {
+        size_t i = 0;
+        while (i < n)
+        {
+            while (i < n && !where(data[i])) ++i;
+
+            const auto begin = i;
+            while (i < n && where(data[i])) ++i;
+
+            if (i > begin) this->NextBatch(data + begin, i - begin);
+        }
+    }
+
+public:
+    explicit WhereObserver(Function<void(const T&)> onNext,
+                           Function<void()> onCompleted,
+                           Function<bool(const T&)> where,
+                           Function<void(const T*, size_t)> onNextBatch = nullptr)
+        : Observer<T>(std::move(onNext), std::move(onCompleted), std::move(onNextBatch)),
+          where(std::move(where)),
+          inBatch(false)
+    {
+    }
+
+    void OnNext(const T& v) override
+    {
+        if (this->isStopped) return;
+
+        if (where(v)) this->_onNext(v);
+    }
+
+    void OnNextBatch(const T* data, size_t n) override
+    {
+        if (this->isStopped) return;
+
+        // 下流から再入された場合は作業領域が使用中なので詰め直さない
+        if (inBatch)
+        {
+            NextBatchFiltered(data, n, std::false_type());
+            return;
+        }
+
+        inBatch = true;
+        NextBatchFiltered(data, n, std::integral_constant<bool, std::is_trivially_copyable<T>::value &&
+                                                               std::is_default_constructible<T>::value>());
+        inBatch = false;
+    }
+};
@@ -0,0 +1,118 @@
+#pragma once
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "../Disposable.h"
+#include "../Observer.h"
+#include "../RxPool.h"
+
+template <typename T>
+class Observable;
+
+// count個ずつの区切り(ウィンドウ)ごとにObservableを流すObserver (skip個ごとに新しいウィンドウを開く)
+// 各ウィンドウは開いた時点から値を流し、count個流したら完了する。開く前の値は届かない
+template <typename T>
+class WindowObserver : public Observer<T>
+{
+    // 1つのウィンドウ (Disposeすると、このウィンドウの購読者全てに流さなくなる)
+    struct Window
+    {
+        std::vector<ObserverPtr<T>> observers;
+        std::shared_ptr<Disposable> disposable = RxPool::MakeShared<Disposable>();
+        size_t received = 0;
+
+        void OnNext(const T& v)
+        {
+            ++received;
+            if (disposable->IsDisposed()) return;
+
+            // 流している最中に購読されたものは次の値から
+            const auto n = observers.size();
+            for (size_t i = 0; i < n && !disposable->IsDisposed(); ++i)
+            {
+                observers[i]->OnNext(v);
+            }
+        }
+
+        void OnCompleted()
+        {
+            auto list = std::move(observers);
+            if (disposable->IsDisposed()) return;
+
+            for (auto&& o : list)
+            {
+                o->OnCompleted();
+            }
+        }
+    };
+
+    ObserverPtr<std::shared_ptr<Observable<T>>> downstream;
+    size_t count;
+    size_t skip;
+    size_t index;
+    std::deque<std::shared_ptr<Window>> open;
+
+    void Open()
+    {
+        auto window = RxPool::MakeShared<Window>();
+        open.push_back(window);
+
+        std::weak_ptr<Window> weakWindow = window;
+        auto disposable = window->disposable;
+        downstream->OnNext(RxPool::MakeShared<Observable<T>>(
+            [weakWindow, disposable](ObserverPtr<T> o)
+            {
+                // 既に閉じたウィンドウには登録しない
+                if (auto w = weakWindow.lock()) w->observers.push_back(o);
+                return disposable;
+            },
+            disposable,
+            nullptr
+        ));
+    }
+
+public:
+    WindowObserver(ObserverPtr<std::shared_ptr<Observable<T>>> downstream, int count, int skip)
+        : Observer<T>(nullptr, nullptr),
+          downstream(std::move(downstream)),
+          count(count > 0 ? static_cast<size_t>(count) : 1),
+          skip(skip > 0 ? static_cast<size_t>(skip) : 1),
+          index(0)
+    {
+    }
+
+    void OnNext(const T& v) override
+    {
+        if (this->isStopped) return;
+
+        if (index++ % skip == 0) Open();
+
+        for (auto&& w : open)
+        {
+            w->OnNext(v);
+        }
+
+        // 満たされたウィンドウを閉じる
+        while (!open.empty() && open.front()->received >= count)
+        {
+            auto w = std::move(open.front());
+            open.pop_front();
+            w->OnCompleted();
+        }
+    }
+
+    void OnCompleted() override
+    {
+        if (this->isStopped) return;
+
+        this->isStopped = true;
+
+        auto list = std::move(open);
+        for (auto&& w : list)
+        {
+            w->OnCompleted();
+        }
+        downstream->OnCompleted();
+    }
+};
@@ -0,0 +1,137 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+#include "../Observer.h"
+#include "../RingBuffer.h"
+#include "BackpressureObserver.h"
+
+// Zipで入力ごとに溜める値の数の既定値
+constexpr size_t DefaultZipCapacity = 256;
+
+// 各入力のn番目の値同士を組にして流す
+// 値は入力ごとの容量固定のリングバッファに積み、購読後は確保しない
+// 他の入力より先行しすぎてバッファが満杯になった入力は、受け取った値を捨てる (組の対応がずれないよう溜まっている値は残す)
+// 捨てた数はstatsがあれば加算される
+// いずれかの入力が完了し、その入力のバッファが空になったら(もう組を作れないので)完了する
+// 注意: スレッドセーフではない (入力は同じスレッドから流すこと)
+template <typename... Ts>
+class ZipState
+{
+    template <typename>
+    static size_t Capacity(size_t capacity) { return capacity; }
+
+    template <size_t... Is>
+    bool AllReady(std::index_sequence<Is...>) const
+    {
+        const bool ready[] = {!std::get<Is>(queues).Empty()...};
+        for (auto r : ready)
+        {
+            if (!r) return false;
+        }
+        return true;
+    }
+
+    template <size_t... Is>
+    void Emit(std::index_sequence<Is...>)
+    {
+        std::tuple<Ts...> values(std::move(std::get<Is>(queues).Front())...);
+        const int pop[] = {(std::get<Is>(queues).PopFront(), 0)...};
+        (void)pop;
+
+        downstream->OnNext(values);
+    }
+
+    template <size_t... Is>
+    bool Exhausted(std::index_sequence<Is...>) const
+    {
+        const bool exhausted[] = {(completed[Is] && std::get<Is>(queues).Empty())...};
+        for (auto e : exhausted)
+        {
+            if (e) return true;
+        }
+        return false;
+    }
+
+public:
+    static constexpr size_t Count = sizeof...(Ts);
+
+    ObserverPtr<std::tuple<Ts...>> downstream;
+    std::tuple<RingBuffer<Ts>...> queues;
+    std::shared_ptr<BackpressureStats> stats;
+    bool completed[Count] = {};
+    bool done = false;
+
+    ZipState(size_t capacity, std::shared_ptr<BackpressureStats> stats)
+        : queues(Capacity<Ts>(capacity)...),
+          stats(std::move(stats))
+    {
+    }
+
+    template <size_t I, typename V>
+    void Next(const V& v)
+    {
+        if (done) return;
+
+        auto& queue = std::get<I>(queues);
+        if (queue.Full())
+        {
+            if (stats != nullptr) stats->AddDropped(1);
+            return;
+        }
+
+        queue.PushBack(v);
+        if (AllReady(std::index_sequence_for<Ts...>())) Emit(std::index_sequence_for<Ts...>());
+
+        CheckCompleted();
+    }
+
+    void Completed(size_t index)
+    {
+        if (done) return;
+
+        completed[index] = true;
+        CheckCompleted();
+    }
+
+    void CheckCompleted()
+    {
+        if (done || !Exhausted(std::index_sequence_for<Ts...>())) return;
+
+        done = true;
+        downstream->OnCompleted();
+    }
+};
+
+// ZipのI番目の入力
+template <size_t I, typename... Ts>
+class ZipObserver : public Observer<typename std::tuple_element<I, std::tuple<Ts...>>::type>
+{
+    using T = typename std::tuple_element<I, std::tuple<Ts...>>::type;
+
+    std::shared_ptr<ZipState<Ts...>> state;
+
+public:
+    explicit ZipObserver(std::shared_ptr<ZipState<Ts...>> state)
+        : Observer<T>(nullptr, nullptr),
+          state(std::move(state))
+    {
+    }
+
+    void OnNext(const T& v) override
+    {
+        if (this->isStopped) return;
+
+        state->template Next<I>(v);
+    }
+
+    void OnCompleted() override
+    {
+        if (this->isStopped) return;
+
+        this->isStopped = true;
+        state->Completed(I);
+    }
+};
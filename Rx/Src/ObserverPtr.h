@@ -0,0 +1,136 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "RxPool.h"
+
+// Observerの所有を単一スレッド用の参照カウントにする (CMakeのRX_SINGLE_THREADEDで有効にする)
+// 対象はオペレータ間でObserverを繋ぐ所有(下流の保持やSubjectの登録)だけで、有効時はその増減が不可分でなくなる
+// 代わりに購読/廃棄と、Observerを抱えたままの別スレッドへの受け渡しは1つのスレッドで行うこと
+// (ConcurrentSubject、スレッドプールのSchedulerを使うObserveOn/OnBackpressure/SubscribeOn、並列配信は使えない)
+//
+// ObservableとDisposableは有効時もstd::shared_ptrのまま (参照カウントは不可分な増減のまま) にしている
+// - どちらもstd::shared_ptrで利用者に渡す型で (オペレータの戻り値、Subscribeの戻り値、GetDisposable、AddTo、
+//   ObservableDestroyTriggerのweak_ptrなど)、std::shared_ptrの制御ブロックの増減は常に不可分になる
+//   ビルドの設定で公開する型を変えずに不可分でない参照カウントにする方法が標準には無い
+// - methodChainParentとdisposableの複製はオペレータのチェーンを組む時の1回だけで、購読/廃棄のたびには起きない
+// このため購読/廃棄のたびに残る不可分な増減は、利用者へ返すDisposable(Subjectの登録解除用やTake等の購読)の分になる
+#ifndef RX_SINGLE_THREADED
+#define RX_SINGLE_THREADED 0
+#endif
+
+template <typename T>
+class Observer;
+
+// 侵入型の参照カウントを持つオブジェクトの基底 (RxPoolから確保し、最後の参照が外れたら破棄する)
+class RefCounted
+{
+    template <typename T>
+    friend class IntrusivePtr;
+
+    size_t refCount = 0;
+
+protected:
+    RefCounted() = default;
+
+public:
+    RefCounted(const RefCounted&) = delete;
+    RefCounted& operator=(const RefCounted&) = delete;
+
+    virtual ~RefCounted() = default;
+
+    // 仮想デストラクタ経由の解放でも実際の型の大きさが渡るので、そのままプールへ返せる
+    static void* operator new(size_t size) { return RxPool::Allocate(size); }
+    static void operator delete(void* p, size_t size) noexcept { RxPool::Deallocate(p, size); }
+};
+
+// RefCountedを指す参照カウント付きポインタ (増減は不可分でないので単一スレッド専用)
+template <typename T>
+class IntrusivePtr
+{
+    template <typename U>
+    friend class IntrusivePtr;
+
+    T* p;
+
+    void Retain() const
+    {
+        if (p != nullptr) ++static_cast<RefCounted*>(p)->refCount;
+    }
+
+public:
+    IntrusivePtr() noexcept: p(nullptr) {}
+    IntrusivePtr(std::nullptr_t) noexcept: p(nullptr) {}
+
+    explicit IntrusivePtr(T* p): p(p) { Retain(); }
+
+    IntrusivePtr(const IntrusivePtr& other): p(other.p) { Retain(); }
+    IntrusivePtr(IntrusivePtr&& other) noexcept: p(other.p) { other.p = nullptr; }
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible<U*, T*>::value>>
+    IntrusivePtr(const IntrusivePtr<U>& other): p(other.p) { Retain(); }
+
+    template <typename U, typename = std::enable_if_t<std::is_convertible<U*, T*>::value>>
+    IntrusivePtr(IntrusivePtr<U>&& other) noexcept: p(other.p) { other.p = nullptr; }
+
+    ~IntrusivePtr() { reset(); }
+
+    IntrusivePtr& operator=(IntrusivePtr other) noexcept
+    {
+        std::swap(p, other.p);
+        return *this;
+    }
+
+    void reset() noexcept
+    {
+        if (p == nullptr) return;
+
+        auto* r = static_cast<RefCounted*>(p);
+        p = nullptr;
+        if (--r->refCount == 0) delete r;
+    }
+
+    T* get() const noexcept { return p; }
+    T* operator->() const noexcept { return p; }
+    T& operator*() const noexcept { return *p; }
+    explicit operator bool() const noexcept { return p != nullptr; }
+
+    friend bool operator==(const IntrusivePtr& a, std::nullptr_t) noexcept { return a.p == nullptr; }
+    friend bool operator!=(const IntrusivePtr& a, std::nullptr_t) noexcept { return a.p != nullptr; }
+};
+
+#if RX_SINGLE_THREADED
+// Observerの基底 (参照カウントを持つ)
+using ObserverBase = RefCounted;
+
+// オペレータのObserverが下流を生かしておくための参照 (8バイト)
+using DownstreamRef = IntrusivePtr<RefCounted>;
+
+template <typename T>
+using ObserverPtr = IntrusivePtr<Observer<T>>;
+
+template <typename X, typename... Args>
+IntrusivePtr<X> MakeObserver(Args&&... args)
+{
+    return IntrusivePtr<X>(new X(std::forward<Args>(args)...));
+}
+#else
+// Observerの基底 (既定では空)
+class ObserverBase
+{
+};
+
+// オペレータのObserverが下流を生かしておくための参照
+using DownstreamRef = std::shared_ptr<void>;
+
+template <typename T>
+using ObserverPtr = std::shared_ptr<Observer<T>>;
+
+template <typename X, typename... Args>
+std::shared_ptr<X> MakeObserver(Args&&... args)
+{
+    return RxPool::MakeShared<X>(std::forward<Args>(args)...);
+}
+#endif
@@ -0,0 +1,341 @@
+#pragma once
+#include <memory>
+#include <tuple>
+#include <utility>
+
+#include "AssignableDisposable.h"
+#include "Disposable.h"
+#include "Observer.h"
+#include "RxPool.h"
+
+// オペレータを型として合成し、チェーン全体を1つのインライン化可能な呼び出しに融合するパイプラインモード
+// 使用例: subject->Pipe(PipeOp::Where(..), PipeOp::Skip(3), PipeOp::Interval(3), PipeOp::Take(3))->Subscribe(..)
+// 型消去はSubjectとの境界(PipeObserver)の1回だけで、各ステージ間は仮想呼び出しもstd::functionも経由しない
+namespace PipeOp
+{
+    // --- ステージ ---
+    // 各ステージは下流ステージを値として保持し、OnNext/OnCompletedを直接呼び出す
+
+    template <typename F, typename Down>
+    class WhereStage
+    {
+        F where;
+        Down down;
+
+    public:
+        WhereStage(F where, Down down): where(std::move(where)), down(std::move(down))
+        {
+        }
+
+        template <typename V>
+        void OnNext(const V& v)
+        {
+            if (where(v)) down.OnNext(v);
+        }
+
+        void OnCompleted() { down.OnCompleted(); }
+    };
+
+    template <typename F, typename Down>
+    class SelectStage
+    {
+        F select;
+        Down down;
+
+    public:
+        SelectStage(F select, Down down): select(std::move(select)), down(std::move(down))
+        {
+        }
+
+        template <typename V>
+        void OnNext(const V& v)
+        {
+            down.OnNext(select(v));
+        }
+
+        void OnCompleted() { down.OnCompleted(); }
+    };
+
+    template <typename Down>
+    class SkipStage
+    {
+        int counter;
+        int skipCount;
+        Down down;
+
+    public:
+        SkipStage(int skipCount, Down down): counter(0), skipCount(skipCount), down(std::move(down))
+        {
+        }
+
+        template <typename V>
+        void OnNext(const V& v)
+        {
+            if (counter < skipCount)
+            {
+                ++counter;
+                return;
+            }
+
+            down.OnNext(v);
+        }
+
+        void OnCompleted() { down.OnCompleted(); }
+    };
+
+    template <typename Down>
+    class IntervalStage
+    {
+        int counter;
+        int intervalCount;
+        Down down;
+
+    public:
+        IntervalStage(int intervalCount, Down down): counter(0), intervalCount(intervalCount), down(std::move(down))
+        {
+        }
+
+        template <typename V>
+        void OnNext(const V& v)
+        {
+            if (counter++ < intervalCount - 1) return;
+
+            counter = 0;
+            down.OnNext(v);
+        }
+
+        void OnCompleted() { down.OnCompleted(); }
+    };
+
+    // オペレータのTakeと同じく、回数が0以下でも最初の1つは流す
+    // 取り終えたら完了済みとし、上流から後で届く完了は下流へ流さない
+    template <typename Down>
+    class TakeStage
+    {
+        int counter;
+        int takeCount;
+        std::shared_ptr<Disposable> disposable;
+        Down down;
+
+    public:
+        TakeStage(int takeCount, std::shared_ptr<Disposable> disposable, Down down)
+            : counter(0), takeCount(takeCount > 0 ? takeCount : 1), disposable(std::move(disposable)), down(std::move(down))
+        {
+        }
+
+        template <typename V>
+        void OnNext(const V& v)
+        {
+            if (counter >= takeCount) return;
+
+            down.OnNext(v);
+
+            if (++counter >= takeCount)
+            {
+                down.OnCompleted();
+                disposable->Dispose();
+            }
+        }
+
+        void OnCompleted()
+        {
+            if (counter >= takeCount) return;
+
+            counter = takeCount;
+            down.OnCompleted();
+        }
+    };
+
+    // 終端 (Subscribeに渡された処理)
+    template <typename F, typename C>
+    class SubscribeStage
+    {
+        F onNext;
+        C onCompleted;
+
+    public:
+        SubscribeStage(F onNext, C onCompleted): onNext(std::move(onNext)), onCompleted(std::move(onCompleted))
+        {
+        }
+
+        template <typename V>
+        void OnNext(const V& v)
+        {
+            onNext(v);
+        }
+
+        void OnCompleted() { onCompleted(); }
+    };
+
+    struct NoCompleted
+    {
+        void operator()() const
+        {
+        }
+    };
+
+    // --- オペレータ (ステージ生成器) ---
+    // Bindで下流ステージを受け取り、自身のステージ型を返す
+
+    template <typename F>
+    struct WhereOp
+    {
+        F where;
+
+        template <typename Down>
+        WhereStage<F, Down> Bind(Down down, const std::shared_ptr<Disposable>&) const
+        {
+            return WhereStage<F, Down>(where, std::move(down));
+        }
+    };
+
+    template <typename F>
+    struct SelectOp
+    {
+        F select;
+
+        template <typename Down>
+        SelectStage<F, Down> Bind(Down down, const std::shared_ptr<Disposable>&) const
+        {
+            return SelectStage<F, Down>(select, std::move(down));
+        }
+    };
+
+    struct SkipOp
+    {
+        int num;
+
+        template <typename Down>
+        SkipStage<Down> Bind(Down down, const std::shared_ptr<Disposable>&) const
+        {
+            return SkipStage<Down>(num, std::move(down));
+        }
+    };
+
+    struct IntervalOp
+    {
+        int num;
+
+        template <typename Down>
+        IntervalStage<Down> Bind(Down down, const std::shared_ptr<Disposable>&) const
+        {
+            return IntervalStage<Down>(num, std::move(down));
+        }
+    };
+
+    struct TakeOp
+    {
+        int num;
+
+        template <typename Down>
+        TakeStage<Down> Bind(Down down, const std::shared_ptr<Disposable>& disposable) const
+        {
+            return TakeStage<Down>(num, disposable, std::move(down));
+        }
+    };
+
+    template <typename F>
+    WhereOp<F> Where(F where) { return WhereOp<F>{std::move(where)}; }
+
+    template <typename F>
+    SelectOp<F> Select(F select) { return SelectOp<F>{std::move(select)}; }
+
+    inline SkipOp Skip(int num) { return SkipOp{num}; }
+
+    inline IntervalOp Interval(int num) { return IntervalOp{num}; }
+
+    inline TakeOp Take(int num) { return TakeOp{num}; }
+
+    // --- 合成 ---
+    namespace Detail
+    {
+        template <typename Sink, typename Tuple>
+        Sink Compose(Sink sink, const std::shared_ptr<Disposable>&, const Tuple&, std::integral_constant<size_t, 0>)
+        {
+            return sink;
+        }
+
+        // 末尾のオペレータから順に、下流ステージを包んでいく
+        template <typename Sink, typename Tuple, size_t N>
+        auto Compose(Sink sink, const std::shared_ptr<Disposable>& disposable, const Tuple& ops,
+                     std::integral_constant<size_t, N>)
+        {
+            return Compose(std::get<N - 1>(ops).Bind(std::move(sink), disposable), disposable, ops,
+                           std::integral_constant<size_t, N - 1>());
+        }
+    }
+}
+
+// 融合したチェーンをSubjectへ登録するための唯一の型消去点
+template <typename T, typename Chain>
+class PipeObserver : public Observer<T>
+{
+    Chain chain;
+
+public:
+    explicit PipeObserver(Chain chain)
+        : Observer<T>(nullptr, nullptr),
+          chain(std::move(chain))
+    {
+    }
+
+    void OnNext(const T& v) override
+    {
+        if (this->isStopped) return;
+
+        chain.OnNext(v);
+    }
+
+    // 要素ごとに仮想呼び出しを挟まないよう、融合したチェーンへ直接流す
+    void OnNextBatch(const T* data, size_t n) override
+    {
+        for (size_t i = 0; i < n && !this->isStopped; ++i)
+        {
+            if (BatchSubscription::IsCancelled()) return;
+            chain.OnNext(data[i]);
+        }
+    }
+
+    void OnCompleted() override
+    {
+        if (this->isStopped) return;
+
+        chain.OnCompleted();
+        this->isStopped = true;
+    }
+};
+
+template <typename T>
+class Observable;
+
+template <typename T, typename... Ops>
+class PipeObservable
+{
+    std::shared_ptr<Observable<T>> source;
+    std::tuple<Ops...> ops;
+
+public:
+    PipeObservable(std::shared_ptr<Observable<T>> source, std::tuple<Ops...> ops)
+        : source(std::move(source)),
+          ops(std::move(ops))
+    {
+    }
+
+    // Take等が廃棄するのはこの購読だけ (上流の購読が決まる前に廃棄された場合は、決まった時点で廃棄される)
+    template <typename F, typename C = PipeOp::NoCompleted>
+    std::shared_ptr<Disposable> Subscribe(F onNext, C onCompleted = C()) const
+    {
+        auto subscription = RxPool::MakeShared<AssignableDisposable>();
+        std::shared_ptr<Disposable> d = subscription;
+        auto chain = PipeOp::Detail::Compose(
+            PipeOp::SubscribeStage<F, C>(std::move(onNext), std::move(onCompleted)),
+            d,
+            ops,
+            std::integral_constant<size_t, sizeof...(Ops)>());
+
+        auto observer = MakeObserver<PipeObserver<T, decltype(chain)>>(std::move(chain));
+        AssignableDisposable::PendingScope pending(subscription.get());
+        subscription->SetInner(source->Subscribe(std::move(observer)));
+        return subscription;
+    }
+};
@@ -0,0 +1,157 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+
+#include "Disposable.h"
+#include "Observable.h"
+#include "Observer.h"
+#include "RingBuffer.h"
+#include "RxPool.h"
+#include "Subject.h"
+#include "Observer/OperatorClock.h"
+
+// 直近の値を溜めておき、購読時にそれらを流してから以降の値を流すサブジェクト
+// 溜める値は容量固定のリングバッファに持ち、容量を超えたら古いものから捨てる (メモリ使用量は生成時に決まる)
+// 購読時は溜めた値をその場で順に流し、一時的な配列へ複製しない
+// 注意: 購読時の再生中にこのサブジェクトへOnNextすると、再生される値がずれることがある
+template <typename T>
+class ReplaySubject
+{
+public:
+    // 直近何フレーム分を溜めるか (フレームはObservableUtil::DoEveryUpdateで進む)
+    struct FrameWindow
+    {
+        uint32_t frames;
+    };
+
+    // フレーム数で区切る場合に溜める数の上限の既定値
+    static constexpr size_t DefaultCapacity = 1024;
+
+private:
+    Subject<T> subject;
+    RingBuffer<T> values;
+    RingBuffer<uint64_t> stamps; // 値を受け取ったフレーム (フレーム数で区切る場合のみ使う)
+    uint32_t window = 0; // 0ならフレーム数で区切らない
+    bool storing; // 溜める数が0なら何も溜めず、再生もしない
+    bool completed = false;
+
+    // 区切りのフレーム数より古いものを捨てる
+    void Trim()
+    {
+        if (window == 0) return;
+
+        const auto now = FrameClock::Now();
+        while (!stamps.Empty() && now - stamps.Front() >= window)
+        {
+            stamps.PopFront();
+            values.PopFront();
+        }
+    }
+
+    void Store(const T& v)
+    {
+        if (!storing) return;
+
+        values.PushBack(v);
+        if (window > 0) stamps.PushBack(FrameClock::Now());
+    }
+
+public:
+    // 直近count個を溜める (0なら何も溜めない)
+    explicit ReplaySubject(size_t count)
+        : values(count),
+          stamps(1),
+          storing(count > 0)
+    {
+    }
+
+    // 直近window.framesフレームの間に受け取った値を、最大capacity個まで溜める (capacityが0なら何も溜めない)
+    explicit ReplaySubject(FrameWindow window, size_t capacity = DefaultCapacity)
+        : values(capacity),
+          stamps(capacity),
+          window(window.frames > 0 ? window.frames : 1),
+          storing(capacity > 0)
+    {
+    }
+
+    ReplaySubject(const ReplaySubject&) = delete;
+    ReplaySubject& operator=(const ReplaySubject&) = delete;
+
+    // 溜まっている値の数
+    size_t Size()
+    {
+        Trim();
+        return values.Size();
+    }
+
+    void OnNext(const T& v)
+    {
+        if (completed) return;
+
+        Store(v);
+        subject.OnNext(v);
+    }
+
+    void OnNextBatch(const T* data, size_t n)
+    {
+        if (completed) return;
+
+        // 容量を超える分は溜めても捨てられるので、末尾の容量分だけ溜める
+        const auto skip = n > values.Capacity() ? n - values.Capacity() : 0;
+        for (size_t i = skip; i < n && storing; ++i)
+        {
+            Store(data[i]);
+        }
+        subject.OnNextBatch(data, n);
+    }
+
+    void OnCompleted()
+    {
+        if (completed) return;
+
+        completed = true;
+        subject.OnCompleted();
+    }
+
+    std::shared_ptr<Observable<T>> GetObservable()
+    {
+        auto inner = subject.GetObservable();
+
+        auto observable = RxPool::MakeShared<Observable<T>>(
+            [this, inner](ObserverPtr<T> o) -> std::shared_ptr<Disposable>
+            {
+                Trim();
+
+                // 再生中に値が追加されても、再生するのは購読時点で溜まっていた数まで
+                const auto count = values.Size();
+                for (size_t i = 0; i < count; ++i)
+                {
+                    o->OnNext(values[i]);
+                }
+
+                if (completed)
+                {
+                    o->OnCompleted();
+
+                    // 登録はしないので、廃棄済みのものを返す
+                    auto d = RxPool::MakeShared<Disposable>();
+                    d->Dispose();
+                    return d;
+                }
+                return inner->Subscribe(o);
+            },
+            inner->GetDisposable(),
+            nullptr
+        );
+        observable->AttachNode(subject.GetNode());
+        return observable;
+    }
+
+    Instrumentation::Node GetNode() const { return subject.GetNode(); }
+
+    template <typename... Ops>
+    std::shared_ptr<PipeObservable<T, Ops...>> Pipe(Ops... ops)
+    {
+        return GetObservable()->Pipe(std::move(ops)...);
+    }
+};
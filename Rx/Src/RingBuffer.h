@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// 容量固定のリングバッファ
+// 領域は生成時に一度だけ確保し、以降の追加/取り出しでは確保しない (既定コンストラクタのない型も格納できる)
+// 注意: スレッドセーフではない
+template <typename T>
+class RingBuffer
+{
+    using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+    std::unique_ptr<Storage[]> storage;
+    size_t capacity;
+    size_t head; // 先頭の位置
+    size_t count;
+
+    T* Slot(size_t i) { return reinterpret_cast<T*>(&storage[(head + i) % capacity]); }
+    const T* Slot(size_t i) const { return reinterpret_cast<const T*>(&storage[(head + i) % capacity]); }
+
+public:
+    explicit RingBuffer(size_t capacity)
+        : storage(new Storage[capacity > 0 ? capacity : 1]),
+          capacity(capacity > 0 ? capacity : 1),
+          head(0),
+          count(0)
+    {
+    }
+
+    ~RingBuffer()
+    {
+        Clear();
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    size_t Capacity() const { return capacity; }
+    size_t Size() const { return count; }
+    bool Empty() const { return count == 0; }
+    bool Full() const { return count == capacity; }
+
+    // 先頭からi番目
+    T& operator[](size_t i) { return *Slot(i); }
+    const T& operator[](size_t i) const { return *Slot(i); }
+
+    T& Front() { return *Slot(0); }
+    T& Back() { return *Slot(count - 1); }
+
+    // 満杯の場合は先頭(最も古いもの)を捨てて追加する。捨てた場合はtrueを返す
+    template <typename U>
+    bool PushBack(U&& v)
+    {
+        bool overwritten = false;
+        if (Full())
+        {
+            PopFront();
+            overwritten = true;
+        }
+
+        new(Slot(count)) T(std::forward<U>(v));
+        ++count;
+        return overwritten;
+    }
+
+    void PopFront()
+    {
+        Slot(0)->~T();
+        head = (head + 1) % capacity;
+        --count;
+    }
+
+    void Clear()
+    {
+        while (count > 0)
+        {
+            PopFront();
+        }
+        head = 0;
+    }
+};
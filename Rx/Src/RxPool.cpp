@@ -0,0 +1,208 @@
+#include "RxPool.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace RxPool
+{
+    constexpr size_t ClassCount = MaxBlockSize / Granularity;
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    // 確保したチャンクの連結リスト (プロセス終了まで解放しない)
+    struct Chunk
+    {
+        Chunk* next;
+    };
+
+    static std::atomic<size_t> globalAllocationCount{0};
+    static std::atomic<Chunk*> chunks{nullptr};
+
+    // 連結したブロックのまとまり (先頭ブロックの領域を使って次のまとまりを指す)
+    struct FreeBatch
+    {
+        FreeBlock* next;
+        FreeBatch* nextBatch;
+    };
+
+    static_assert(sizeof(FreeBatch) <= Granularity, "FreeBatch must fit in the smallest block");
+
+    // スレッド間で受け渡すブロック (溜め込みすぎたスレッドが返した分と、終了したスレッドが残した分)
+    // 別スレッドで解放されたブロックはそのスレッドに溜まるので、確保するスレッドはここから1まとまりずつ引き取る
+    static std::mutex sharedMutex;
+    static FreeBatch* sharedBatches[ClassCount];
+
+    // 破棄後(静的オブジェクトの破棄中など)に解放されても壊れないよう、自明な型のみで持つ
+    static thread_local FreeBlock* freeLists[ClassCount];
+    static thread_local size_t freeCounts[ClassCount];
+    static thread_local size_t threadAllocationCount;
+    static thread_local bool exitRegistered;
+
+    // 先頭はチャンク管理に使うので1ブロック分ずらして切り分ける
+    constexpr size_t ChunkHeaderSize = (sizeof(Chunk) + Granularity - 1) / Granularity * Granularity;
+
+    static size_t BlockSize(size_t classIndex)
+    {
+        return (classIndex + 1) * Granularity;
+    }
+
+    static size_t BlocksPerChunk(size_t classIndex)
+    {
+        return (ChunkSize - ChunkHeaderSize) / BlockSize(classIndex);
+    }
+
+    // 連結したブロックを1まとまりとして共有のリストへ返す
+    static void ReturnShared(size_t classIndex, FreeBlock* head)
+    {
+        auto batch = reinterpret_cast<FreeBatch*>(head);
+        std::lock_guard<std::mutex> lock(sharedMutex);
+        batch->nextBatch = sharedBatches[classIndex];
+        sharedBatches[classIndex] = batch;
+    }
+
+    struct ThreadExit
+    {
+        bool registered = false;
+
+        ~ThreadExit()
+        {
+            for (size_t i = 0; i < ClassCount; ++i)
+            {
+                if (freeLists[i] == nullptr) continue;
+
+                ReturnShared(i, freeLists[i]);
+                freeLists[i] = nullptr;
+                freeCounts[i] = 0;
+            }
+        }
+    };
+
+    static thread_local ThreadExit threadExit;
+
+    // 終了時にフリーリストを共有のリストへ返すよう登録する
+    static void RegisterThreadExit()
+    {
+        threadExit.registered = true;
+        exitRegistered = true;
+    }
+
+    static size_t ClassIndex(size_t size)
+    {
+        return (size + Granularity - 1) / Granularity - 1;
+    }
+
+    static void Refill(size_t classIndex)
+    {
+        if (!exitRegistered) RegisterThreadExit();
+
+        // 他のスレッドが返したブロックがあれば1まとまり引き取る
+        FreeBatch* batch;
+        {
+            std::lock_guard<std::mutex> lock(sharedMutex);
+            batch = sharedBatches[classIndex];
+            if (batch != nullptr) sharedBatches[classIndex] = batch->nextBatch;
+        }
+        if (batch != nullptr)
+        {
+            size_t count = 0;
+            for (auto block = batch->next; block != nullptr; block = block->next) ++count;
+            freeLists[classIndex] = reinterpret_cast<FreeBlock*>(batch);
+            freeCounts[classIndex] = count + 1;
+            return;
+        }
+
+        globalAllocationCount.fetch_add(1, std::memory_order_relaxed);
+        auto memory = static_cast<char*>(::operator new(ChunkSize));
+
+        auto chunk = reinterpret_cast<Chunk*>(memory);
+        chunk->next = chunks.load();
+        while (!chunks.compare_exchange_weak(chunk->next, chunk))
+        {
+        }
+
+        const auto blockSize = BlockSize(classIndex);
+        FreeBlock* head = nullptr;
+        size_t count = 0;
+        for (auto p = memory + ChunkHeaderSize; p + blockSize <= memory + ChunkSize; p += blockSize)
+        {
+            auto block = reinterpret_cast<FreeBlock*>(p);
+            block->next = head;
+            head = block;
+            ++count;
+        }
+        freeLists[classIndex] = head;
+        freeCounts[classIndex] = count;
+    }
+
+    // 溜まりすぎたフリーリストから1チャンク分を共有のリストへ返す
+    // (確保と解放が別スレッドの場合に、解放側に溜まり続けて確保側がチャンクを切り出し続けないように)
+    static void Trim(size_t classIndex)
+    {
+        const auto count = BlocksPerChunk(classIndex);
+        auto head = freeLists[classIndex];
+        auto tail = head;
+        for (size_t i = 1; i < count; ++i)
+        {
+            tail = tail->next;
+        }
+
+        freeLists[classIndex] = tail->next;
+        freeCounts[classIndex] -= count;
+        tail->next = nullptr;
+        ReturnShared(classIndex, head);
+    }
+
+    void* Allocate(size_t size)
+    {
+        if (size == 0) size = 1;
+        if (size > MaxBlockSize)
+        {
+            globalAllocationCount.fetch_add(1, std::memory_order_relaxed);
+            return ::operator new(size);
+        }
+
+        const auto classIndex = ClassIndex(size);
+        if (freeLists[classIndex] == nullptr) Refill(classIndex);
+
+        auto block = freeLists[classIndex];
+        freeLists[classIndex] = block->next;
+        --freeCounts[classIndex];
+        ++threadAllocationCount;
+        return block;
+    }
+
+    void Deallocate(void* p, size_t size) noexcept
+    {
+        if (p == nullptr) return;
+        if (size == 0) size = 1;
+        if (size > MaxBlockSize)
+        {
+            ::operator delete(p);
+            return;
+        }
+
+        // 別スレッドで確保されたブロックでも、解放したスレッドのフリーリストに入れて再利用する
+        // 2チャンク分を超えたら1チャンク分を共有のリストへ返し、確保側のスレッドが引き取れるようにする
+        const auto classIndex = ClassIndex(size);
+        auto block = static_cast<FreeBlock*>(p);
+        block->next = freeLists[classIndex];
+        freeLists[classIndex] = block;
+        if (++freeCounts[classIndex] > BlocksPerChunk(classIndex) * 2) Trim(classIndex);
+
+        // 解放だけするスレッドも、終了時にフリーリストを返す
+        if (!exitRegistered) RegisterThreadExit();
+    }
+
+    size_t GlobalAllocationCount()
+    {
+        return globalAllocationCount.load(std::memory_order_relaxed);
+    }
+
+    size_t ThreadAllocationCount()
+    {
+        return threadAllocationCount;
+    }
+}
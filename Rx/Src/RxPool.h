@@ -0,0 +1,89 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+// 購読の組み立て/廃棄で使う小さなオブジェクト用のサイズクラス別プール
+// スレッドごとのフリーリストから払い出し、足りなくなった時だけ大域アロケータからまとめて確保する
+// (確保したチャンクはプロセス終了まで保持し、解放されたブロックはフリーリストに戻して再利用する)
+// 別スレッドで解放されたブロックは解放側に溜まり、溜まりすぎた分はスレッド間で共有するリストを通して確保側へ戻る
+namespace RxPool
+{
+    constexpr size_t Granularity = 16;
+    constexpr size_t MaxBlockSize = 512; // これより大きいものは大域アロケータへ
+    constexpr size_t ChunkSize = 64 * 1024;
+
+    void* Allocate(size_t size);
+    void Deallocate(void* p, size_t size) noexcept;
+
+    // プールが大域アロケータを呼んだ回数 (チャンク確保と、プール対象外サイズの確保)
+    size_t GlobalAllocationCount();
+    // 呼び出し元スレッドでプールから払い出した回数
+    size_t ThreadAllocationCount();
+
+    template <typename T>
+    class Allocator
+    {
+    public:
+        using value_type = T;
+
+        Allocator() = default;
+
+        template <typename U>
+        Allocator(const Allocator<U>&) noexcept
+        {
+        }
+
+        T* allocate(size_t n)
+        {
+            return static_cast<T*>(alignof(T) <= Granularity
+                                       ? Allocate(n * sizeof(T))
+                                       : ::operator new(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, size_t n) noexcept
+        {
+            if (alignof(T) <= Granularity) Deallocate(p, n * sizeof(T));
+            else ::operator delete(p);
+        }
+
+        template <typename U>
+        bool operator==(const Allocator<U>&) const noexcept { return true; }
+
+        template <typename U>
+        bool operator!=(const Allocator<U>&) const noexcept { return false; }
+    };
+
+    // 制御ブロックごとプールから確保するmake_shared
+    template <typename T, typename... Args>
+    std::shared_ptr<T> MakeShared(Args&&... args)
+    {
+        return std::allocate_shared<T>(Allocator<T>(), std::forward<Args>(args)...);
+    }
+
+    template <typename T, typename... Args>
+    T* New(Args&&... args)
+    {
+        Allocator<T> allocator;
+        auto p = allocator.allocate(1);
+        try
+        {
+            return new(p) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            allocator.deallocate(p, 1);
+            throw;
+        }
+    }
+
+    template <typename T>
+    void Delete(T* p) noexcept
+    {
+        if (p == nullptr) return;
+
+        p->~T();
+        Allocator<T>().deallocate(p, 1);
+    }
+}
@@ -3,6 +3,7 @@
 #include <memory>
 #include <string>
 
+#include "../Coroutine.h"
 #include "../Observable.h"
 #include "../ObservableDestroyTrigger.h"
 #include "../ObservableUtil.h"
@@ -219,6 +220,115 @@ class SampleFunc
         subject->OnNext(Unit());
     }
 
+    // オペレータを融合したパイプラインで登録する例
+    static void PipeSample(const std::shared_ptr<Subject<std::string>>& subject)
+    {
+        auto _ = subject->Pipe(PipeOp::Select([](const std::string& s) { return atoi(s.c_str()); }),
+                               PipeOp::Where([](int i) { return i > 0; }),
+                               PipeOp::Take(2))
+                        ->Subscribe([](int i)
+                                    {
+                                        std::cout << "value: " << i << std::endl;
+                                    },
+                                    []
+                                    {
+                                        std::cout << "Completed." << std::endl;
+                                    });
+
+        // 実行処理
+        std::cout << "Send value." << std::endl;
+        subject->OnNext("123");
+
+        std::cout << "Send value. (2)" << std::endl;
+        subject->OnNext("0");
+
+        std::cout << "Send value. (3)" << std::endl;
+        subject->OnNext("456");
+
+        std::cout << "Send value. (4)" << std::endl;
+        subject->OnNext("789");
+    }
+
+    // 1フレームに受け取った値をまとめて処理する例
+    static void BufferFrameSample(const std::shared_ptr<Subject<int>>& subject)
+    {
+        auto _ = subject->GetObservable()
+                        ->BufferFrame(1)
+                        ->Subscribe([](const Span<int>& values)
+                        {
+                            int sum = 0;
+                            for (auto v : values)
+                            {
+                                sum += v;
+                            }
+                            std::cout << values.size() << " values, sum: " << sum << std::endl;
+                        });
+
+        // 実行処理
+        std::cout << "Send value." << std::endl;
+        subject->OnNext(1);
+        subject->OnNext(2);
+        subject->OnNext(3);
+
+        std::cout << "Update." << std::endl;
+        ObservableUtil::DoEveryUpdate();
+    }
+
+    // 上流のオペレータを購読者間で共有する例 (Selectは購読者の数によらず1回だけ評価される)
+    static void ShareSample(const std::shared_ptr<Subject<int>>& subject)
+    {
+        auto o = subject->GetObservable()
+                        ->Select<int>([](int i)
+                        {
+                            std::cout << "Select" << std::endl;
+                            return i * 2;
+                        })
+                        ->Share();
+
+        auto d1 = o->Subscribe([](int i) { std::cout << "A: " << i << std::endl; });
+        auto d2 = o->Subscribe([](int i) { std::cout << "B: " << i << std::endl; });
+
+        // 実行処理
+        std::cout << "Send value." << std::endl;
+        subject->OnNext(1);
+
+        // 全ての購読を廃棄すると上流から切断される
+        d1->Dispose();
+        d2->Dispose();
+        std::cout << "Send value." << std::endl;
+        subject->OnNext(2);
+    }
+
+#if RX_COROUTINES
+    // 最初の値を受け取ってから、3フレームおきに計3回処理するコルーチン
+    static Task CoroutineTask(std::shared_ptr<Observable<std::string>> source)
+    {
+        auto s = co_await source->FirstAsync();
+        for (int i = 0; i < 3; ++i)
+        {
+            co_await Frames(3);
+            std::cout << s << " (frame " << FrameTimerWheel::Main().Frame() << ")" << std::endl;
+        }
+        std::cout << "Completed." << std::endl;
+    }
+
+    // コルーチンでフレーム待ちを書く例 (RX_COROUTINES=ONでビルドした場合のみ)
+    static void CoroutineSample(const std::shared_ptr<Subject<std::string>>& subject)
+    {
+        auto task = CoroutineTask(subject->GetObservable());
+
+        // 実行処理
+        subject->OnNext("Hoge");
+        for (int i = 0; i < 10; ++i)
+        {
+            ObservableUtil::DoEveryUpdate();
+        }
+
+        // 途中で止める場合はDisposeする
+        task.GetDisposable()->Dispose();
+    }
+#endif
+
 public:
     static void DoIt()
     {
@@ -245,5 +355,19 @@ public:
 
         // 同一メソッドチェーンSubscribeしない場合の例
         ColdObservableSample();
+
+        // オペレータを融合したパイプラインで登録する例
+        // PipeSample(std::make_shared<Subject<std::string>>());
+
+        // 1フレームに受け取った値をまとめて処理する例
+        // BufferFrameSample(std::make_shared<Subject<int>>());
+
+        // 上流のオペレータを購読者間で共有する例
+        // ShareSample(std::make_shared<Subject<int>>());
+
+#if RX_COROUTINES
+        // コルーチンでフレーム待ちを書く例
+        // CoroutineSample(std::make_shared<Subject<std::string>>());
+#endif
     }
 };
@@ -0,0 +1,193 @@
+#include "Scheduler.h"
+
+#include <algorithm>
+
+// --- Scheduler ---
+
+std::shared_ptr<Scheduler> Scheduler::Immediate()
+{
+    static auto instance = std::make_shared<ImmediateScheduler>();
+    return instance;
+}
+
+std::shared_ptr<Scheduler> Scheduler::CurrentThread()
+{
+    static auto instance = std::make_shared<CurrentThreadScheduler>();
+    return instance;
+}
+
+std::shared_ptr<Scheduler> Scheduler::MainThread()
+{
+    static auto instance = std::make_shared<MainThreadScheduler>();
+    return instance;
+}
+
+std::shared_ptr<Scheduler> Scheduler::ThreadPool()
+{
+    static auto instance = std::make_shared<ThreadPoolScheduler>();
+    return instance;
+}
+
+// --- ImmediateScheduler ---
+
+void ImmediateScheduler::Schedule(Function<void()> action)
+{
+    action();
+}
+
+// --- CurrentThreadScheduler ---
+
+static thread_local bool trampolineRunning = false;
+static thread_local std::deque<Function<void()>>* trampolineQueue = nullptr;
+
+void CurrentThreadScheduler::Schedule(Function<void()> action)
+{
+    // 実行中の処理から呼ばれた場合は積むだけ
+    if (trampolineRunning)
+    {
+        trampolineQueue->push_back(std::move(action));
+        return;
+    }
+
+    std::deque<Function<void()>> queue;
+    trampolineQueue = &queue;
+    trampolineRunning = true;
+
+    action();
+    while (!queue.empty())
+    {
+        auto next = std::move(queue.front());
+        queue.pop_front();
+        next();
+    }
+
+    trampolineRunning = false;
+    trampolineQueue = nullptr;
+}
+
+// --- MainThreadScheduler ---
+
+void MainThreadScheduler::Schedule(Function<void()> action)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    queue.push_back(std::move(action));
+}
+
+void MainThreadScheduler::Drain()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (queue.empty()) return;
+        std::swap(queue, running);
+    }
+
+    for (auto&& action : running)
+    {
+        action();
+    }
+    running.clear();
+}
+
+// --- ThreadPoolScheduler ---
+
+// 実行中のワーカーが属するプールと番号 (ワーカー外ではnullptr)
+static thread_local ThreadPoolScheduler* currentPool = nullptr;
+static thread_local size_t currentWorker = 0;
+
+ThreadPoolScheduler::ThreadPoolScheduler(size_t threadCount)
+{
+    threadCount = std::max<size_t>(1, threadCount);
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        workers.emplace_back(new Worker());
+    }
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        threads.emplace_back([this, i] { Run(i); });
+    }
+}
+
+ThreadPoolScheduler::~ThreadPoolScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    sleepCondition.notify_all();
+
+    for (auto&& t : threads)
+    {
+        t.join();
+    }
+}
+
+void ThreadPoolScheduler::Schedule(Function<void()> action)
+{
+    const auto index = currentPool == this
+                           ? currentWorker
+                           : nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+    {
+        auto& worker = *workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back(std::move(action));
+    }
+    pending.fetch_add(1);
+
+    // 眠りに入る直前のワーカーが通知を取りこぼさないよう、一度ロックを通してから起こす
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    sleepCondition.notify_one();
+}
+
+bool ThreadPoolScheduler::TryPop(size_t index, Function<void()>& task)
+{
+    auto& worker = *workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) return false;
+
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPoolScheduler::TrySteal(size_t index, Function<void()>& task)
+{
+    for (size_t i = 1; i < workers.size(); ++i)
+    {
+        auto& victim = *workers[(index + i) % workers.size()];
+        std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || victim.tasks.empty()) continue;
+
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void ThreadPoolScheduler::Run(size_t index)
+{
+    currentPool = this;
+    currentWorker = index;
+
+    Function<void()> task;
+    while (true)
+    {
+        if (TryPop(index, task) || TrySteal(index, task))
+        {
+            pending.fetch_sub(1);
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        if (pending.load() > 0) continue; // 盗みに失敗しただけなのでもう一度探す
+        if (stopping) break;
+
+        sleepCondition.wait(lock, [this] { return pending.load() > 0 || stopping; });
+    }
+
+    currentPool = nullptr;
+}
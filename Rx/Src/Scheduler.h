@@ -0,0 +1,86 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Function.h"
+
+// 処理の実行場所を決めるスケジューラ
+class Scheduler
+{
+public:
+    virtual ~Scheduler() = default;
+
+    virtual void Schedule(Function<void()> action) = 0;
+
+    // その場で実行
+    static std::shared_ptr<Scheduler> Immediate();
+    // 呼び出し元スレッドで、実行中の処理が終わってから順に実行 (再帰的なスケジュールを平坦化する)
+    static std::shared_ptr<Scheduler> CurrentThread();
+    // ObservableUtil::DoEveryUpdate()の先頭でまとめて実行
+    static std::shared_ptr<Scheduler> MainThread();
+    // コア数分のワーカーを持つスレッドプールで実行
+    static std::shared_ptr<Scheduler> ThreadPool();
+};
+
+class ImmediateScheduler : public Scheduler
+{
+public:
+    void Schedule(Function<void()> action) override;
+};
+
+class CurrentThreadScheduler : public Scheduler
+{
+public:
+    void Schedule(Function<void()> action) override;
+};
+
+class MainThreadScheduler : public Scheduler
+{
+    std::mutex mutex;
+    std::vector<Function<void()>> queue;
+    std::vector<Function<void()>> running; // 実行中のもの (確保した領域を使い回す)
+
+public:
+    void Schedule(Function<void()> action) override;
+
+    // 溜まっている処理を実行する (実行中にスケジュールされたものは次回)
+    void Drain();
+};
+
+// ワーカーごとにタスクの両端キューを持ち、自分のキューが空になったら他のワーカーから盗むスレッドプール
+// ワーカー上からのスケジュールは自分のキューに積まれ、後入れ先出しで処理される (盗む側は先頭から)
+class ThreadPoolScheduler : public Scheduler
+{
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    std::atomic<size_t> pending{0};
+    std::atomic<size_t> nextWorker{0};
+    bool stopping = false;
+
+    bool TryPop(size_t index, Function<void()>& task);
+    bool TrySteal(size_t index, Function<void()>& task);
+    void Run(size_t index);
+
+public:
+    explicit ThreadPoolScheduler(size_t threadCount = std::thread::hardware_concurrency());
+    ~ThreadPoolScheduler() override;
+
+    void Schedule(Function<void()> action) override;
+
+    size_t ThreadCount() const { return threads.size(); }
+};
@@ -0,0 +1,114 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// SlotMapへの登録を指すハンドル (世代番号で解放済みスロットの再利用を見分ける)
+struct SlotHandle
+{
+    uint32_t index;
+    uint32_t generation;
+};
+
+// 値を密な配列に詰めて保持し、ハンドル経由でO(1)の追加/削除を行うコンテナ
+// 削除は印を付けるだけで、Compactでまとめて詰める (要素は追加した順に並ぶ)
+template <typename V>
+class SlotMap
+{
+    struct Slot
+    {
+        uint32_t denseIndex;
+        uint32_t generation;
+    };
+
+    // 削除済みの印 (denseToSlotに入れる)
+    static constexpr uint32_t Erased = UINT32_MAX;
+
+    std::vector<V> values; // 密配列 (走査用)
+    std::vector<uint32_t> denseToSlot; // 密配列の要素 → スロット番号
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    size_t erasedCount = 0; // 詰めていない削除済みの要素数
+
+public:
+    SlotHandle Insert(V v)
+    {
+        uint32_t slotIndex;
+        if (!freeSlots.empty())
+        {
+            slotIndex = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            slotIndex = static_cast<uint32_t>(slots.size());
+            slots.push_back(Slot{0, 0});
+        }
+
+        auto& slot = slots[slotIndex];
+        slot.denseIndex = static_cast<uint32_t>(values.size());
+        values.emplace_back(std::move(v));
+        denseToSlot.emplace_back(slotIndex);
+
+        return SlotHandle{slotIndex, slot.generation};
+    }
+
+    bool Contains(SlotHandle handle) const
+    {
+        return handle.index < slots.size() && slots[handle.index].generation == handle.generation;
+    }
+
+    // 既に削除済み(世代不一致)のハンドルは無視する
+    // 要素はCompactまで密配列に残る (走査中に呼んでも並びは崩れない)
+    bool Erase(SlotHandle handle)
+    {
+        if (!Contains(handle)) return false;
+
+        auto& slot = slots[handle.index];
+        denseToSlot[slot.denseIndex] = Erased;
+        ++erasedCount;
+
+        ++slot.generation;
+        freeSlots.emplace_back(handle.index);
+        return true;
+    }
+
+    // 削除済みの要素を取り除いて詰める。残りの並び順は保つ (走査中には呼ばないこと)
+    void Compact()
+    {
+        if (erasedCount == 0) return;
+
+        size_t out = 0;
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            if (denseToSlot[i] == Erased) continue;
+
+            if (out != i)
+            {
+                values[out] = std::move(values[i]);
+                denseToSlot[out] = denseToSlot[i];
+                slots[denseToSlot[out]].denseIndex = static_cast<uint32_t>(out);
+            }
+            ++out;
+        }
+        values.erase(values.begin() + static_cast<std::ptrdiff_t>(out), values.end());
+        denseToSlot.resize(out);
+        erasedCount = 0;
+    }
+
+    // 削除済みでCompactしていない要素
+    bool IsErased(size_t denseIndex) const { return denseToSlot[denseIndex] == Erased; }
+
+    // Compactしていない削除済みの要素も含む
+    size_t Size() const { return values.size(); }
+    bool Empty() const { return values.empty(); }
+
+    V& operator[](size_t denseIndex) { return values[denseIndex]; }
+    const V& operator[](size_t denseIndex) const { return values[denseIndex]; }
+
+    typename std::vector<V>::iterator begin() { return values.begin(); }
+    typename std::vector<V>::iterator end() { return values.end(); }
+    typename std::vector<V>::const_iterator begin() const { return values.begin(); }
+    typename std::vector<V>::const_iterator end() const { return values.end(); }
+};
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+
+// 連続した値への参照 (std::spanの代わり)
+// Buffer等が下流へ渡すもので、参照先は通知中のみ有効。保持したい場合はコピーすること
+template <typename T>
+class Span
+{
+    const T* ptr;
+    size_t count;
+
+public:
+    Span(): ptr(nullptr), count(0)
+    {
+    }
+
+    Span(const T* data, size_t size): ptr(data), count(size)
+    {
+    }
+
+    const T* data() const { return ptr; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    const T& operator[](size_t i) const { return ptr[i]; }
+    const T& front() const { return ptr[0]; }
+    const T& back() const { return ptr[count - 1]; }
+
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + count; }
+};
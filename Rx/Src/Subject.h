@@ -1,10 +1,24 @@
 ﻿#pragma once
-#include <list>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 
+#include "CompositeDisposable.h"
+#include "Instrumentation.h"
 #include "Observable.h"
 #include "Observer.h"
+#include "RxPool.h"
+#include "Scheduler.h"
+#include "SlotMap.h"
+#include "Trace.h"
+
+// 並列配信で1つのワーカーがまとめて通知する独立な購読者の数の既定値
+constexpr size_t DefaultParallelChunkSize = 512;
 
 template <typename T>
 class Subject
@@ -12,22 +26,40 @@ class Subject
     // Disposeで該当Observerの登録解除ができるようペアにしておく
     struct Source
     {
-        std::shared_ptr<Observer<T>> observer;
+        ObserverPtr<T> observer;
         std::shared_ptr<Disposable> disposer;
 
-        Source(std::shared_ptr<Observer<T>> observer, std::shared_ptr<Disposable> disposer)
+        Source(ObserverPtr<T> observer, std::shared_ptr<Disposable> disposer)
             : observer(std::move(observer)),
               disposer(std::move(disposer))
         {
         }
     };
 
+    // 並列配信中のワーカーで廃棄された独立な購読者のハンドルの退避先 (配信後にまとめて廃棄予定に積む)
+    struct DeferredDisposals
+    {
+        const std::vector<SlotHandle>* owner = nullptr; // 配信中のSubjectの廃棄予定リスト
+        std::mutex* mutex = nullptr;
+        std::vector<SlotHandle>* handles = nullptr;
+    };
+
+    static DeferredDisposals& Deferred()
+    {
+        static thread_local DeferredDisposals deferred;
+        return deferred;
+    }
+
+    // 購読1つ分の登録解除 (購読ごとに作る)
     struct Disposer : Disposable
     {
-        std::list<Source>* src;
-        std::list<Source*>* willDispose;
+        SlotHandle handle;
+        std::vector<SlotHandle>* willDispose;
+#if RX_INSTRUMENTATION
+        Instrumentation::Node node;
+#endif
 
-        Disposer(std::list<Source>* src, std::list<Source*>* willDispose): src(src), willDispose(willDispose)
+        explicit Disposer(std::vector<SlotHandle>* willDispose): willDispose(willDispose)
         {
         }
 
@@ -37,13 +69,20 @@ class Subject
         {
             if (IsDisposed()) return;
 
-            for (auto itr = src->begin(); itr != src->end();)
+            // 並列配信中のワーカーからの廃棄は、配信の終了後に廃棄予定へ積まれる
+            auto& deferred = Deferred();
+            if (willDispose != nullptr && deferred.owner == willDispose)
             {
-                if ((*itr).disposer.get() == this)
-                {
-                    willDispose->emplace_back(&*itr);
-                }
-                ++itr;
+                std::lock_guard<std::mutex> lock(*deferred.mutex);
+                deferred.handles->push_back(handle);
+            }
+            // 走査は不要。ハンドルを廃棄予定に積むだけ (Subjectが先に破棄されていれば何もしない)
+            else if (willDispose != nullptr)
+            {
+                willDispose->push_back(handle);
+#if RX_INSTRUMENTATION
+                Instrumentation::SetPendingDispose(node, willDispose->size());
+#endif
             }
 
             // 基底を呼ぶのを忘れずに。(忘れると、寿命が来る前に手動Disposeした場合にエラーとなる)
@@ -51,73 +90,327 @@ class Subject
         }
     };
 
+    // 独立な購読者の並列配信で、ワーカーと共有する状態 (Subjectごとに1つ作って配信のたびに使い回す)
+    // ワーカーへはこれへのポインタだけを渡す。配信の受付(open)が閉じた後に遅れて起動したワーカーは、
+    // 配信ごとの設定(Subjectの登録物や通知処理)には触らずに終わる
+    struct ParallelJob
+    {
+        // 配信ごとの設定 (受付中のみ有効)
+        const SlotMap<Source>* sources = nullptr;
+        const std::vector<SlotHandle>* owner = nullptr;
+        const void* notify = nullptr;
+        void (*invoke)(const void* notify, const Source& s) = nullptr;
+        size_t count = 0;
+        size_t chunkSize = 0;
+        size_t chunkCount = 0;
+
+        std::atomic<bool> open{false};
+        std::atomic<size_t> inside{0}; // 受付を確かめてから出るまでの間のワーカーの数
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> finished{0};
+        // ワーカーで廃棄されたもの (配信後にまとめて廃棄予定に積む)
+        std::mutex mutex;
+        std::vector<SlotHandle> disposed;
+
+        // 受付中なら残っている塊を取って通知する
+        // (配信側は受付を閉じた後、受付を確かめている最中のワーカーが出るまで待つので、設定が途中で書き換わることはない)
+        void Run()
+        {
+            inside.fetch_add(1, std::memory_order_seq_cst);
+            if (open.load(std::memory_order_seq_cst))
+            {
+                auto& deferred = Deferred();
+                const auto saved = deferred;
+                deferred = DeferredDisposals{owner, &mutex, &disposed};
+
+                for (auto c = next.fetch_add(1, std::memory_order_relaxed); c < chunkCount;
+                     c = next.fetch_add(1, std::memory_order_relaxed))
+                {
+                    const auto end = std::min(count, (c + 1) * chunkSize);
+                    for (auto i = c * chunkSize; i < end; ++i)
+                    {
+                        const auto& s = (*sources)[i];
+                        if (!s.disposer->IsDisposed()) invoke(notify, s);
+                    }
+                    finished.fetch_add(1, std::memory_order_release);
+                }
+
+                deferred = saved;
+            }
+            inside.fetch_sub(1, std::memory_order_release);
+        }
+    };
+
     // 登録物
-    std::list<Source> source;
+    SlotMap<Source> source;
     // 廃棄予定のもの
-    std::list<Source*> willDisposeSourceList;
+    std::vector<SlotHandle> willDisposeSourceList;
+    // 互いに独立していると宣言された登録物 (GetIndependentObservableから購読したもの) とその廃棄予定
+    SlotMap<Source> independentSource;
+    std::vector<SlotHandle> willDisposeIndependentList;
+    // 並列配信に使うスレッドプール (nullptrなら独立な購読者も逐次に通知する)
+    std::shared_ptr<ThreadPoolScheduler> parallelPool;
+    size_t parallelChunkSize = DefaultParallelChunkSize;
+    std::shared_ptr<ParallelJob> parallelJob;
+    // OnNext/OnCompletedの入れ子の深さ (走査中は廃棄を遅延させる)
+    int dispatchDepth = 0;
+#if RX_INSTRUMENTATION
+    Instrumentation::Node node = Instrumentation::MakeNode("Subject", nullptr);
+#endif
+
+    // 計測用の購読数/廃棄予定数を更新する
+    void Sample()
+    {
+#if RX_INSTRUMENTATION
+        Instrumentation::SetSubscribers(node, source.Size() + independentSource.Size());
+        Instrumentation::SetPendingDispose(node, willDisposeSourceList.size() + willDisposeIndependentList.size());
+#endif
+    }
 
     // 廃棄予定のものを廃棄
     void Dispose()
     {
-        for (auto willItr = willDisposeSourceList.begin(); willItr != willDisposeSourceList.end();)
+        // 再入したOnNextの中で廃棄すると外側の走査中の並びが崩れるので、最も外側まで遅延させる
+        if (dispatchDepth > 0) return;
+
+        // 登録順を保ったまま、まとめて詰める
+        for (auto&& handle : willDisposeSourceList)
         {
-            auto isHit = false;
+            source.Erase(handle);
+        }
+        willDisposeSourceList.clear();
+        source.Compact();
 
-            for (auto itr = source.begin(); itr != source.end();)
-            {
-                if (&*itr == *willItr)
-                {
-                    itr = source.erase(itr);
-                    isHit = true;
-                    break;
-                }
-                ++itr;
-            }
+        for (auto&& handle : willDisposeIndependentList)
+        {
+            independentSource.Erase(handle);
+        }
+        willDisposeIndependentList.clear();
+        independentSource.Compact();
+
+        Sample();
+    }
 
-            if (isHit)
+    // 独立な購読者へ通知する。並列配信が有効なら塊に分けてスレッドプールで通知し、全て終わるまで待つ
+    // (呼び出し元スレッドも塊を処理するので、プールが埋まっていても待ち続けることはない)
+    // notifyは廃棄されていない登録物(Source)ごとに呼ばれる
+    template <typename F>
+    void NotifyIndependent(const F& notify)
+    {
+        const auto count = independentSource.Size();
+        const auto chunkSize = parallelChunkSize;
+        if (parallelPool == nullptr || count <= chunkSize)
+        {
+            for (size_t i = 0; i < count; ++i)
             {
-                willItr = willDisposeSourceList.erase(willItr);
-                continue;
+                if (independentSource[i].disposer->IsDisposed()) continue;
+                notify(independentSource[i]);
             }
-            ++willItr;
+            return;
+        }
+
+        auto& job = *parallelJob;
+        job.sources = &independentSource;
+        job.owner = &willDisposeIndependentList;
+        job.notify = &notify;
+        job.invoke = [](const void* f, const Source& s) { (*static_cast<const F*>(f))(s); };
+        job.count = count;
+        job.chunkSize = chunkSize;
+        job.chunkCount = (count + chunkSize - 1) / chunkSize;
+        job.next.store(0, std::memory_order_relaxed);
+        job.finished.store(0, std::memory_order_relaxed);
+        job.open.store(true, std::memory_order_seq_cst);
+
+        const auto helperCount = std::min(parallelPool->ThreadCount(), job.chunkCount - 1);
+        for (size_t i = 0; i < helperCount; ++i)
+        {
+            parallelPool->Schedule([pJob = parallelJob] { pJob->Run(); });
         }
+        job.Run();
+
+        // 他のワーカーが処理中の塊の完了を待ち、受付を閉じる
+        while (job.finished.load(std::memory_order_acquire) < job.chunkCount)
+        {
+            std::this_thread::yield();
+        }
+        // (受付の確認と閉じる処理が入れ違っても、どちらかが相手を必ず見るようseq_cstで行う)
+        job.open.store(false, std::memory_order_seq_cst);
+        while (job.inside.load(std::memory_order_seq_cst) != 0)
+        {
+            std::this_thread::yield();
+        }
+
+        // ワーカーで廃棄されたものは、ここで廃棄予定に合流させる
+        willDisposeIndependentList.insert(willDisposeIndependentList.end(), job.disposed.begin(), job.disposed.end());
+        job.disposed.clear();
+    }
+
+    std::shared_ptr<Observable<T>> MakeObservable(SlotMap<Source>& target, std::vector<SlotHandle>& willDispose)
+    {
+        auto group = RxPool::MakeShared<CompositeDisposable>();
+
+        auto* map = &target;
+        auto* pending = &willDispose;
+        auto observable = RxPool::MakeShared<Observable<T>>(
+            [this, group, map, pending](ObserverPtr<T> o) -> std::shared_ptr<Disposable>
+            {
+                auto disposer = RxPool::MakeShared<Disposer>(pending);
+#if RX_INSTRUMENTATION
+                disposer->node = node;
+#endif
+                disposer->handle = map->Insert(Source(std::move(o), disposer));
+                group->Add(disposer);
+                Sample();
+                return disposer;
+            },
+            group,
+            nullptr
+        );
+        observable->AttachNode(GetNode());
+        return observable;
     }
 
 public:
-    void OnNext(T v)
+    Subject() = default;
+
+    Subject(const Subject&) = delete;
+    Subject& operator=(const Subject&) = delete;
+
+    // ObservableDestroyTrigger等がDisposerを保持したままSubjectより長生きしても大丈夫なように切り離しておく
+    ~Subject()
     {
+        for (auto&& s : source)
+        {
+            static_cast<Disposer*>(s.disposer.get())->willDispose = nullptr;
+        }
+        for (auto&& s : independentSource)
+        {
+            static_cast<Disposer*>(s.disposer.get())->willDispose = nullptr;
+        }
+    }
+
+    // 独立な購読者(GetIndependentObservableから購読したもの)を、指定のスレッドプールでchunkSize個ずつ並列に通知する
+    // OnNextは全ての通知が終わってから戻り、通知中にワーカーで廃棄されたものは戻る前にまとめて廃棄予定に積まれる
+    // poolにnullptrを渡すと逐次の通知に戻る
+    void SetParallelDispatch(std::shared_ptr<ThreadPoolScheduler> pool =
+                                 std::static_pointer_cast<ThreadPoolScheduler>(Scheduler::ThreadPool()),
+                             size_t chunkSize = DefaultParallelChunkSize)
+    {
+        parallelPool = std::move(pool);
+        parallelChunkSize = std::max<size_t>(1, chunkSize);
+        if (parallelPool != nullptr && parallelJob == nullptr) parallelJob = RxPool::MakeShared<ParallelJob>();
+    }
+
+    void OnNext(const T& v)
+    {
+        Trace::Scope scope("Subject::OnNext");
+#if RX_INSTRUMENTATION
+        Instrumentation::ScopedTimer timer(node);
+#endif
+
         // Dispose単体で呼んだ場合は、予約されただけの状態なのでここで廃棄される
         Dispose();
 
-        for (auto&& e : source)
+        // 走査中の登録で配列が再確保されても良いよう添字でアクセスする (走査中に登録されたものは次回から)
+        ++dispatchDepth;
+        const auto count = source.Size();
+#if RX_INSTRUMENTATION
+        Instrumentation::AddIn(node, 1);
+        Instrumentation::AddOut(node, count + independentSource.Size());
+#endif
+        for (size_t i = 0; i < count; ++i)
         {
-            e.observer->OnNext(v);
+            // 走査中に廃棄されたもの(掃除は走査後)には流さない
+            if (source[i].disposer->IsDisposed()) continue;
+            source[i].observer->OnNext(v);
         }
+        NotifyIndependent([&v](const Source& s) { s.observer->OnNext(v); });
+        --dispatchDepth;
 
         // OnNext処理内にてDisposeを呼んだ場合はここで廃棄される
         Dispose();
     }
 
+    // 連続した値をまとめて流す。廃棄の掃除は1回のバッチにつき前後1回ずつ
+    // (各Observerにはバッチ全体が順に渡されるため、Observer間の呼び出し順はOnNextを繰り返した場合と異なる)
+    void OnNextBatch(const T* data, size_t n)
+    {
+        Trace::Scope scope("Subject::OnNextBatch");
+#if RX_INSTRUMENTATION
+        Instrumentation::ScopedTimer timer(node);
+#endif
+
+        Dispose();
+
+        ++dispatchDepth;
+        const auto count = source.Size();
+#if RX_INSTRUMENTATION
+        Instrumentation::AddIn(node, n);
+        Instrumentation::AddOut(node, (count + independentSource.Size()) * n);
+#endif
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (source[i].disposer->IsDisposed()) continue;
+
+            // 1つずつに分けて流す途中で廃棄された場合に残りを止められるよう、配信中の購読を知らせておく
+            BatchSubscription::Scope batch(source[i].disposer.get());
+            source[i].observer->OnNextBatch(data, n);
+        }
+        NotifyIndependent([data, n](const Source& s)
+        {
+            BatchSubscription::Scope batch(s.disposer.get());
+            s.observer->OnNextBatch(data, n);
+        });
+        --dispatchDepth;
+
+        Dispose();
+    }
+
     void OnCompleted()
     {
-        for (auto&& e : source)
+        ++dispatchDepth;
+        const auto count = source.Size();
+        for (size_t i = 0; i < count; ++i)
         {
-            e.observer->OnCompleted();
+            if (source[i].disposer->IsDisposed()) continue;
+            source[i].observer->OnCompleted();
         }
+        // 完了は逐次に通知する
+        const auto independentCount = independentSource.Size();
+        for (size_t i = 0; i < independentCount; ++i)
+        {
+            if (independentSource[i].disposer->IsDisposed()) continue;
+            independentSource[i].observer->OnCompleted();
+        }
+        --dispatchDepth;
     }
 
     std::shared_ptr<Observable<T>> GetObservable()
     {
-        auto disposer = std::make_shared<Disposer>(&source, &willDisposeSourceList);
+        return MakeObservable(source, willDisposeSourceList);
+    }
+
+    // 他の購読者と状態を共有しない購読者用のObservable (SetParallelDispatchで並列に通知される)
+    // 通知は通常の購読者の後で、並列時はワーカースレッドから呼ばれる。購読者の処理から触れてよいのは自身の状態と、
+    // 自身の購読の廃棄だけ (同じSubjectへのOnNextや、他の購読者の廃棄は不可)
+    std::shared_ptr<Observable<T>> GetIndependentObservable()
+    {
+        return MakeObservable(independentSource, willDisposeIndependentList);
+    }
 
-        return std::make_shared<Observable<T>>(
-            [=](std::shared_ptr<Observer<T>> o)
-            {
-                source.emplace_back(o, disposer);
-                return disposer;
-            },
-            disposer,
-            nullptr
-        );
+    // 計測用のノード (計測無効時は空)
+    Instrumentation::Node GetNode() const
+    {
+#if RX_INSTRUMENTATION
+        return node;
+#else
+        return {};
+#endif
+    }
+
+    template <typename... Ops>
+    std::shared_ptr<PipeObservable<T, Ops...>> Pipe(Ops... ops)
+    {
+        return GetObservable()->Pipe(std::move(ops)...);
     }
 };
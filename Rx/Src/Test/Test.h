@@ -1,13 +1,40 @@
 ﻿#pragma once
 
 #pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
 #include <string>
-
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "../BehaviorSubject.h"
+#include "../CompositeDisposable.h"
+#include "../ConcurrentSubject.h"
+#include "../Coroutine.h"
+#include "../EventLog.h"
+#include "../FrameTimerWheel.h"
+#include "../Function.h"
+#include "../Instrumentation.h"
 #include "../Observable.h"
 #include "../ObservableDestroyTrigger.h"
+#include "../ObservableUtil.h"
+#include "../ReplaySubject.h"
+#include "../Scheduler.h"
+#include "../Span.h"
 #include "../Subject.h"
+#include "../Trace.h"
 #include "../Unit.h"
 
 namespace Test
@@ -406,6 +433,2498 @@ namespace Test
 
         return {test1 && test2 && test3 , "ColdObservableTest"};
     }
+
+    // 大量登録・一部廃棄テスト
+    static TestResult ManySubscribeDisposeTest()
+    {
+        int res = 0;
+
+        const auto subject = std::make_shared<Subject<Unit>>();
+        std::vector<std::shared_ptr<Disposable>> disposers;
+        for (int i = 0; i < 1000; i++)
+        {
+            disposers.emplace_back(subject->GetObservable()
+                                          ->Subscribe([&](Unit _) mutable
+                                          {
+                                              ++res;
+                                          }));
+        }
+
+        // 実行処理
+        subject->OnNext(Unit());
+        bool test1 = res == 1000;
+
+        for (size_t i = 0; i < disposers.size(); i += 2)
+        {
+            disposers[i]->Dispose();
+            disposers[i]->Dispose(); // 二重Disposeは無視される
+        }
+
+        res = 0;
+        subject->OnNext(Unit());
+        bool test2 = res == 500;
+
+        // 廃棄で空いたスロットの再利用
+        auto d = subject->GetObservable()
+                        ->Subscribe([&](Unit _) mutable
+                        {
+                            res += 10000;
+                        });
+
+        res = 0;
+        subject->OnNext(Unit());
+        bool test3 = res == 10500;
+
+        return {test1 && test2 && test3, "ManySubscribeDisposeTest"};
+    }
+
+    // OnNext内で再度OnNextした場合の廃棄テスト
+    static TestResult ReentrantDisposeTest()
+    {
+        int res1 = 0, res2 = 0, res3 = 0;
+
+        const auto subject = std::make_shared<Subject<int>>();
+        static std::shared_ptr<Disposable> d1;
+        d1 = subject->GetObservable()
+                    ->Subscribe([&](int i) mutable
+                    {
+                        ++res1;
+                        d1->Dispose();
+
+                        // 再入したOnNextの中では登録は消されない(外側のOnNext終了時に消える)が、廃棄済みなので流れない
+                        if (i == 0) subject->OnNext(1);
+                    });
+
+        auto d2 = subject->GetObservable()
+                         ->Subscribe([&](int i) mutable
+                         {
+                             ++res2;
+                         });
+
+        auto d3 = subject->GetObservable()
+                         ->Subscribe([&](int i) mutable
+                         {
+                             ++res3;
+                         });
+
+        // 実行処理
+        subject->OnNext(0);
+        bool test1 = res1 == 1 && res2 == 2 && res3 == 2;
+
+        subject->OnNext(2);
+        bool test2 = res1 == 1 && res2 == 3 && res3 == 3;
+
+        d1 = nullptr;
+        return {test1 && test2, "ReentrantDisposeTest"};
+    }
+
+    // コピー回数を数えるペイロード
+    struct CopyCounter
+    {
+        std::string payload;
+
+        static int& Copies()
+        {
+            static int copies = 0;
+            return copies;
+        }
+
+        explicit CopyCounter(std::string payload): payload(std::move(payload))
+        {
+        }
+
+        CopyCounter(const CopyCounter& other): payload(other.payload) { ++Copies(); }
+        CopyCounter(CopyCounter&& other) noexcept = default;
+
+        CopyCounter& operator=(const CopyCounter& other)
+        {
+            payload = other.payload;
+            ++Copies();
+            return *this;
+        }
+
+        CopyCounter& operator=(CopyCounter&& other) noexcept = default;
+    };
+
+    // 値の伝搬でコピーが発生しないことのテスト
+    static TestResult NoCopyPropagationTest()
+    {
+        int res = 0;
+
+        const auto subject = std::make_shared<Subject<CopyCounter>>();
+        std::vector<std::shared_ptr<Disposable>> disposers;
+        for (int i = 0; i < 3; i++)
+        {
+            disposers.emplace_back(subject->GetObservable()
+                                          ->Select<CopyCounter>([](const CopyCounter& c)
+                                          {
+                                              return CopyCounter(c.payload + c.payload);
+                                          })
+                                          ->Where([](const CopyCounter& c) { return !c.payload.empty(); })
+                                          ->Skip(0)
+                                          ->Take(10)
+                                          ->Interval(1)
+                                          ->Subscribe([&](const CopyCounter& c) mutable
+                                          {
+                                              res += static_cast<int>(c.payload.size());
+                                          }));
+        }
+
+        disposers.emplace_back(subject->Pipe(PipeOp::Select([](const CopyCounter& c)
+                                             {
+                                                 return CopyCounter(c.payload + c.payload);
+                                             }),
+                                             PipeOp::Where([](const CopyCounter& c) { return !c.payload.empty(); }),
+                                             PipeOp::Take(10))
+                                      ->Subscribe([&](const CopyCounter& c) mutable
+                                      {
+                                          res += static_cast<int>(c.payload.size());
+                                      }));
+
+        // 実行処理
+        CopyCounter::Copies() = 0;
+        const CopyCounter value("a large payload that does not fit in the small string buffer");
+        subject->OnNext(value);
+        subject->OnNext(CopyCounter("temporary"));
+
+        return {CopyCounter::Copies() == 0 && res > 0, "NoCopyPropagationTest"};
+    }
+
+    // OnNextBatch テスト (1つずつOnNextした場合と結果が一致すること)
+    static TestResult OnNextBatchTest()
+    {
+        std::vector<int> res1, res2;
+        bool completed1 = false, completed2 = false;
+
+        const auto subscribe = [](const std::shared_ptr<Subject<int>>& subject, std::vector<int>& res, bool& completed)
+        {
+            return subject->GetObservable()
+                          ->Where([](int i) { return i % 3 != 0; })
+                          ->Select<int>([](int i) { return i * 10; })
+                          ->Skip(2)
+                          ->Interval(2)
+                          ->Take(8)
+                          ->Subscribe([&](int i) mutable
+                                      {
+                                          res.emplace_back(i);
+                                      },
+                                      [&]() mutable
+                                      {
+                                          completed = true;
+                                      });
+        };
+
+        const auto subject1 = std::make_shared<Subject<int>>();
+        const auto subject2 = std::make_shared<Subject<int>>();
+        auto d1 = subscribe(subject1, res1, completed1);
+        auto d2 = subscribe(subject2, res2, completed2);
+
+        std::vector<int> values(100);
+        for (int i = 0; i < 100; i++)
+        {
+            values[i] = i;
+        }
+
+        // 実行処理
+        for (auto&& v : values)
+        {
+            subject1->OnNext(v);
+        }
+
+        // バッチの境界をまたぐように分割して流す
+        subject2->OnNextBatch(values.data(), 7);
+        subject2->OnNextBatch(values.data() + 7, 30);
+        subject2->OnNextBatch(values.data() + 37, values.size() - 37);
+
+        bool test1 = res1.size() == 8 && res1 == res2;
+        bool test2 = completed1 && completed2;
+
+        // Take(0)もOnNextと同じく最初の1つを流して完了する
+        std::vector<int> res3, res4;
+        int completed3 = 0, completed4 = 0;
+        const auto subject3 = std::make_shared<Subject<int>>();
+        const auto subject4 = std::make_shared<Subject<int>>();
+        auto d3 = subject3->GetObservable()->Take(0)->Subscribe([&](int i) mutable { res3.emplace_back(i); },
+                                                                [&]() mutable { completed3++; });
+        auto d4 = subject4->GetObservable()->Take(0)->Subscribe([&](int i) mutable { res4.emplace_back(i); },
+                                                                [&]() mutable { completed4++; });
+        subject3->OnNext(values[1]);
+        subject3->OnNext(values[2]);
+        subject4->OnNextBatch(values.data() + 1, 2);
+        bool test3 = res3 == std::vector<int>{1} && res3 == res4 && completed3 == 1 && completed4 == 1 &&
+                     d3->IsDisposed() && d4->IsDisposed();
+
+        return {test1 && test2 && test3, "OnNextBatchTest"};
+    }
+
+    // コピーが重い型のOnNextBatch テスト
+    static TestResult OnNextBatchStringTest()
+    {
+        std::vector<std::string> res1, res2;
+
+        const auto subscribe = [](const std::shared_ptr<Subject<std::string>>& subject, std::vector<std::string>& res)
+        {
+            return subject->GetObservable()
+                          ->Where([](const std::string& s) { return s != "Fuga"; })
+                          ->Interval(2)
+                          ->Subscribe([&](const std::string& s) mutable
+                          {
+                              res.emplace_back(s);
+                          });
+        };
+
+        const auto subject1 = std::make_shared<Subject<std::string>>();
+        const auto subject2 = std::make_shared<Subject<std::string>>();
+        auto d1 = subscribe(subject1, res1);
+        auto d2 = subscribe(subject2, res2);
+
+        const std::vector<std::string> values = {"a", "Fuga", "b", "c", "Fuga", "Fuga", "d", "e", "f"};
+
+        // 実行処理
+        for (auto&& v : values)
+        {
+            subject1->OnNext(v);
+        }
+        subject2->OnNextBatch(values.data(), values.size());
+
+        return {!res1.empty() && res1 == res2, "OnNextBatchStringTest"};
+    }
+
+    // 購読の組み立て/廃棄を繰り返しても、定常状態では大域アロケータを呼ばないことのテスト
+    static TestResult PoolAllocationTest()
+    {
+        int res = 0;
+
+        const auto subject = std::make_shared<Subject<int>>();
+        const auto subscribe = [&]
+        {
+            subject->GetObservable()
+                   ->Select<int>([](int i) { return i * 2; })
+                   ->Where([](int i) { return i > 0; })
+                   ->Take(1)
+                   ->Subscribe([&](int i) mutable
+                   {
+                       res += i;
+                   });
+            subject->OnNext(1);
+        };
+
+        // プールが温まるまで回す
+        for (int i = 0; i < 100; i++)
+        {
+            subscribe();
+        }
+
+        // 実行処理
+        const auto before = RxPool::GlobalAllocationCount();
+        for (int i = 0; i < 1000; i++)
+        {
+            subscribe();
+        }
+        const auto after = RxPool::GlobalAllocationCount();
+
+        return {before == after && res == 2200, "PoolAllocationTest"};
+    }
+
+    // ConcurrentSubject 複数スレッドからのOnNext/Subscribe/Disposeテスト
+    static TestResult ConcurrentSubjectStressTest()
+    {
+        constexpr int producerCount = 4;
+        constexpr int emitCount = 20000;
+        constexpr int churnCount = 2000;
+
+        std::atomic<long long> res{0};
+        std::atomic<long long> churnRes{0};
+
+        const auto subject = std::make_shared<ConcurrentSubject<int>>();
+        auto d = subject->GetObservable()
+                        ->Where([](int i) { return i > 0; })
+                        ->Subscribe([&](int i)
+                        {
+                            res.fetch_add(i, std::memory_order_relaxed);
+                        });
+
+        // 実行処理
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producerCount; p++)
+        {
+            threads.emplace_back([&]
+            {
+                for (int i = 0; i < emitCount; i++)
+                {
+                    subject->OnNext(1);
+                }
+            });
+        }
+
+        // 発行中に登録・廃棄を繰り返す
+        threads.emplace_back([&]
+        {
+            for (int i = 0; i < churnCount; i++)
+            {
+                auto churn = subject->GetObservable()
+                                    ->Subscribe([&](int v)
+                                    {
+                                        churnRes.fetch_add(v, std::memory_order_relaxed);
+                                    });
+                churn->Dispose();
+            }
+        });
+
+        for (auto&& t : threads)
+        {
+            t.join();
+        }
+
+        bool test1 = res.load() == static_cast<long long>(producerCount) * emitCount;
+        bool test2 = subject->SubscriberCount() == 1;
+
+        d->Dispose();
+        subject->OnNext(1);
+        bool test3 = res.load() == static_cast<long long>(producerCount) * emitCount;
+        bool test4 = subject->SubscriberCount() == 0;
+
+        return {test1 && test2 && test3 && test4, "ConcurrentSubjectStressTest"};
+    }
+
+    // ObserveOn(MainThread) テスト
+    static TestResult ObserveOnMainThreadTest()
+    {
+        std::vector<int> res;
+
+        const auto subject = std::make_shared<Subject<int>>();
+        auto d = subject->GetObservable()
+                        ->ObserveOn(Scheduler::MainThread())
+                        ->Subscribe([&](int i) mutable
+                        {
+                            res.emplace_back(i);
+                        });
+
+        // 実行処理
+        subject->OnNext(1);
+        subject->OnNext(2);
+        bool test1 = res.empty(); // DoEveryUpdateまでは届かない
+
+        ObservableUtil::DoEveryUpdate();
+        bool test2 = res == std::vector<int>{1, 2};
+
+        subject->OnNext(3);
+        d->Dispose();
+        ObservableUtil::DoEveryUpdate();
+        bool test3 = res.size() == 2; // 廃棄後は届かない
+
+        return {test1 && test2 && test3, "ObserveOnMainThreadTest"};
+    }
+
+    // ObserveOn(ThreadPool) で順序が保たれることのテスト
+    static TestResult ObserveOnThreadPoolTest()
+    {
+        constexpr int count = 10000;
+        std::vector<int> res;
+        std::atomic<int> received{0};
+        std::atomic<bool> completed{false};
+
+        const auto subject = std::make_shared<Subject<int>>();
+        auto d = subject->GetObservable()
+                        ->ObserveOn(Scheduler::ThreadPool())
+                        ->Subscribe([&](int i) mutable
+                                    {
+                                        res.emplace_back(i);
+                                        received.fetch_add(1);
+                                    },
+                                    [&]() mutable
+                                    {
+                                        completed.store(true);
+                                    });
+
+        // 実行処理
+        for (int i = 0; i < count; i++)
+        {
+            subject->OnNext(i);
+        }
+        subject->OnCompleted();
+
+        while (!completed.load())
+        {
+            std::this_thread::yield();
+        }
+
+        bool test1 = received.load() == count;
+        bool test2 = true;
+        for (int i = 0; i < count && test2; i++)
+        {
+            test2 = res[i] == i;
+        }
+
+        d->Dispose();
+        return {test1 && test2, "ObserveOnThreadPoolTest"};
+    }
+
+    // SubscribeOn テスト
+    static TestResult SubscribeOnTest()
+    {
+        int res1 = 0, res2 = 0;
+
+        const auto subject = std::make_shared<Subject<int>>();
+        auto d1 = subject->GetObservable()
+                         ->SubscribeOn(Scheduler::MainThread())
+                         ->Subscribe([&](int i) mutable
+                         {
+                             res1 += i;
+                         });
+
+        auto d2 = subject->GetObservable()
+                         ->SubscribeOn(Scheduler::MainThread())
+                         ->Subscribe([&](int i) mutable
+                         {
+                             res2 += i;
+                         });
+        d2->Dispose(); // 購読される前に廃棄
+
+        // 実行処理
+        subject->OnNext(1);
+        bool test1 = res1 == 0; // DoEveryUpdateまでは購読されていない
+
+        ObservableUtil::DoEveryUpdate();
+        subject->OnNext(2);
+        bool test2 = res1 == 2 && res2 == 0;
+
+        d1->Dispose();
+        subject->OnNext(3);
+        bool test3 = res1 == 2;
+
+        return {test1 && test2 && test3, "SubscribeOnTest"};
+    }
+
+    // CurrentThreadScheduler テスト (再帰的なスケジュールは実行中の処理の後に行われる)
+    static TestResult CurrentThreadSchedulerTest()
+    {
+        std::string res;
+
+        const auto scheduler = Scheduler::CurrentThread();
+        scheduler->Schedule([&]
+        {
+            res += "a";
+            scheduler->Schedule([&]
+            {
+                res += "c";
+                scheduler->Schedule([&] { res += "e"; });
+                res += "d";
+            });
+            res += "b";
+        });
+
+        return {res == "abcde", "CurrentThreadSchedulerTest"};
+    }
+
+    // FrameTimerWheel が段をまたぐ遅延でも指定フレームちょうどに発火することのテスト
+    static TestResult FrameTimerWheelTest()
+    {
+        FrameTimerWheel wheel;
+
+        const std::vector<uint32_t> delays = {1, 2, 255, 256, 257, 1000, 16383, 16384, 20000, 1u << 20, 300000};
+        std::vector<uint64_t> fired(delays.size(), 0);
+        for (size_t i = 0; i < delays.size(); ++i)
+        {
+            wheel.Schedule(delays[i], [&, i] { fired[i] = wheel.Frame(); });
+        }
+
+        // 解除したものは発火しない
+        bool cancelledFired = false;
+        wheel.Schedule(500, [&] { cancelledFired = true; })->Dispose();
+
+        // 周期タイマー (途中で自身を解除する)
+        int periodicCount = 0;
+        std::shared_ptr<Disposable> periodic;
+        periodic = wheel.Schedule(100, [&]
+        {
+            if (++periodicCount == 30) periodic->Dispose();
+        }, 100);
+
+        while (wheel.Frame() < (1u << 20) + 10)
+        {
+            wheel.Advance();
+        }
+
+        bool test1 = true;
+        for (size_t i = 0; i < delays.size(); ++i)
+        {
+            test1 = test1 && fired[i] == delays[i];
+        }
+        bool test2 = !cancelledFired;
+        bool test3 = periodicCount == 30;
+        bool test4 = wheel.Count() == 0;
+
+        return {test1 && test2 && test3 && test4, "FrameTimerWheelTest"};
+    }
+
+    // EveryUpdate のフレーム指定オペレータ(Interval/Skip/DelayFrame/TimerFrame)のテスト
+    static TestResult FrameOperatorTest()
+    {
+        std::vector<int> interval;
+        std::vector<int> skip;
+        std::vector<int> delay;
+        std::vector<int> timer;
+        bool timerCompleted = false;
+        int frame = 0;
+
+        ObservableUtil::EveryUpdate()
+            ->Interval(3)
+            ->Take(2)
+            ->Subscribe([&](Unit _) mutable { interval.emplace_back(frame); });
+
+        auto skipDisposable = ObservableUtil::EveryUpdate()
+                              ->Skip(2)
+                              ->Subscribe([&](Unit _) mutable { skip.emplace_back(frame); });
+
+        const auto subject = std::make_shared<Subject<int>>();
+        subject->GetObservable()
+               ->DelayFrame(2)
+               ->Subscribe([&](int i) mutable { delay.emplace_back(i * 100 + frame); });
+
+        ObservableUtil::TimerFrame(4)
+            ->Subscribe([&](Unit _) mutable { timer.emplace_back(frame); },
+                        [&]() mutable { timerCompleted = true; });
+
+        subject->OnNext(1); // フレーム2で届く
+        while (frame < 10)
+        {
+            ++frame;
+            if (frame == 3) subject->OnNext(2); // フレーム4で届く
+            if (frame == 5) skipDisposable->Dispose();
+            ObservableUtil::DoEveryUpdate();
+        }
+
+        bool test1 = interval == std::vector<int>{3, 6};
+        bool test2 = skip == std::vector<int>{3, 4}; // フレーム3から流れ、フレーム5で廃棄
+        bool test3 = delay == std::vector<int>{102, 204};
+        bool test4 = timer == std::vector<int>{4} && timerCompleted;
+
+        return {test1 && test2 && test3 && test4, "FrameOperatorTest"};
+    }
+
+    // 複数の購読をAddToした場合に、寿命同期用オブジェクトの破棄で全て廃棄されることのテスト
+    static TestResult AddToMultipleTest()
+    {
+        constexpr int count = 20;
+        int res = 0;
+
+        struct LifeTimeObject : ObservableDestroyTrigger
+        {
+        };
+        auto lifetimeObj = std::make_shared<LifeTimeObject>();
+
+        const auto subject = std::make_shared<Subject<int>>();
+        const auto other = std::make_shared<Subject<int>>();
+        for (int i = 0; i < count; ++i)
+        {
+            (i % 2 == 0 ? subject : other)->GetObservable()
+                                          ->Subscribe([&](int v) mutable { res += v; })
+                                          ->AddTo(lifetimeObj);
+        }
+
+        // 実行処理
+        subject->OnNext(1);
+        other->OnNext(1);
+        bool test1 = res == count;
+
+        lifetimeObj = nullptr; // 寿命同期用オブジェクトを削除
+
+        subject->OnNext(1);
+        other->OnNext(1);
+        bool test2 = res == count;
+
+        // Subjectより寿命同期用オブジェクトの方が長生きしても問題ないこと
+        auto longLivedObj = std::make_shared<LifeTimeObject>();
+        {
+            auto shortLived = std::make_shared<Subject<int>>();
+            shortLived->GetObservable()->Subscribe([&](int v) mutable { res += v; })->AddTo(longLivedObj);
+        }
+        longLivedObj = nullptr;
+
+        return {test1 && test2, "AddToMultipleTest"};
+    }
+
+    // CompositeDisposable のテスト
+    static TestResult CompositeDisposableTest()
+    {
+        int res = 0;
+        const auto subject = std::make_shared<Subject<int>>();
+        const auto composite = std::make_shared<CompositeDisposable>();
+
+        // 完了済み(廃棄済み)の購読は追加時に取り除かれ、溜まり続けない
+        for (int i = 0; i < 100; ++i)
+        {
+            composite->Add(subject->GetObservable()->Take(1)->Subscribe([&](int v) mutable { res += v; }));
+            subject->OnNext(1);
+        }
+        bool test1 = res == 100 && composite->Count() <= 5;
+
+        std::vector<std::shared_ptr<Disposable>> alive;
+        for (int i = 0; i < 10; ++i)
+        {
+            alive.emplace_back(subject->GetObservable()->Subscribe([&](int v) mutable { res += v; }));
+            composite->Add(alive.back());
+        }
+
+        // Removeしたものは廃棄されない
+        bool test2 = composite->Remove(alive[0]) && !composite->Remove(alive[0]);
+
+        composite->Dispose();
+        subject->OnNext(1);
+        bool test3 = res == 101 && composite->Count() == 0;
+
+        bool test4 = true;
+        for (size_t i = 1; i < alive.size(); ++i)
+        {
+            test4 = test4 && alive[i]->IsDisposed();
+        }
+        test4 = test4 && !alive[0]->IsDisposed();
+
+        // 廃棄後に追加したものはその場で廃棄される
+        auto late = subject->GetObservable()->Subscribe([&](int v) mutable { res += v; });
+        composite->Add(late);
+        bool test5 = late->IsDisposed();
+
+        alive[0]->Dispose();
+        return {test1 && test2 && test3 && test4 && test5, "CompositeDisposableTest"};
+    }
+
+    // 計測のテスト (計測無効時は何も記録されないこと)
+    static TestResult InstrumentationTest()
+    {
+        const auto subject = std::make_shared<Subject<int>>();
+        auto where = subject->GetObservable()->Where([](int i) { return i % 2 == 0; });
+        auto select = where->Select<int>([](int i) { return i * 10; });
+        auto d = select->Subscribe([](int) {});
+
+        // 実行処理
+        for (int i = 0; i < 10; ++i)
+        {
+            subject->OnNext(i);
+        }
+        d->Dispose();
+
+        const auto s = Instrumentation::GetStats(subject->GetNode());
+        const auto w = Instrumentation::GetStats(where->GetNode());
+        const auto sel = Instrumentation::GetStats(select->GetNode());
+
+        std::ostringstream dot;
+        Instrumentation::WriteDot(dot);
+
+#if RX_INSTRUMENTATION
+        bool test1 = s.in == 10 && s.out == 10 && s.subscribers == 1 && s.pendingDispose == 1;
+        bool test2 = w.in == 10 && w.out == 5 && w.parentId == s.id && w.name == "Where";
+        bool test3 = sel.in == 5 && sel.out == 5 && sel.parentId == w.id;
+        bool test4 = dot.str().find("n" + std::to_string(w.id) + " -> n" + std::to_string(sel.id)) != std::string::npos;
+
+        subject->OnNext(0);
+        test1 = test1 && Instrumentation::GetStats(subject->GetNode()).subscribers == 0;
+#else
+        bool test1 = std::is_empty<Instrumentation::Node>::value;
+        bool test2 = s.in == 0 && w.in == 0 && sel.in == 0;
+        bool test3 = dot.str() == "digraph Rx {\n}\n";
+        bool test4 = true;
+#endif
+
+        return {test1 && test2 && test3 && test4, "InstrumentationTest"};
+    }
+
+    // トレースのテスト (トレース無効時は何も記録されないこと)
+    static TestResult TraceTest()
+    {
+        Trace::Clear();
+
+        const auto subject = std::make_shared<Subject<Trace::Stamped<int>>>();
+        static Trace::LatencyHistogram latency("TraceTest");
+        latency.Reset();
+
+        // スレッドを跨いだ遅延を測る
+        std::atomic<int> received{0};
+        auto d = subject->GetObservable()
+                        ->Where([](const Trace::Stamped<int>& v) { return v.value % 2 == 0; })
+                        ->ObserveOn(Scheduler::ThreadPool())
+                        ->Subscribe([&](const Trace::Stamped<int>& v) mutable
+                        {
+                            latency.Record(v);
+                            received.fetch_add(1);
+                        });
+
+        // 実行処理
+        for (int i = 0; i < 10; ++i)
+        {
+            subject->OnNext(Trace::Stamp(i));
+        }
+        while (received.load() < 5)
+        {
+            std::this_thread::yield();
+        }
+        d->Dispose();
+
+        std::ostringstream trace;
+        Trace::WriteChromeTrace(trace);
+        std::ostringstream report;
+        Trace::WriteLatency(report);
+
+        bool test1 = trace.str().find("\"traceEvents\"") != std::string::npos;
+#if RX_TRACING
+        bool test2 = trace.str().find("Subject::OnNext") != std::string::npos &&
+                     trace.str().find("\"Where\"") != std::string::npos &&
+                     trace.str().find("Subscriber::OnNext") != std::string::npos;
+        bool test3 = latency.Count() == 5 && latency.Percentile(0.5) > 0;
+#else
+        bool test2 = trace.str().find("Subject::OnNext") == std::string::npos;
+        bool test3 = latency.Count() == 0 && sizeof(Trace::Stamped<int>) == sizeof(int);
+#endif
+        bool test4 = report.str().find("TraceTest") != std::string::npos;
+
+        return {test1 && test2 && test3 && test4, "TraceTest"};
+    }
+
+    // Buffer テスト
+    static TestResult BufferTest()
+    {
+        using Buffers = std::vector<std::vector<int>>;
+        Buffers res1, res2, res3, res4;
+        const auto collect = [](Buffers& res)
+        {
+            return [&res](const Span<int>& s) mutable
+            {
+                res.emplace_back(s.begin(), s.end());
+            };
+        };
+
+        const auto subject = std::make_shared<Subject<int>>();
+        subject->GetObservable()->Buffer(3)->Subscribe(collect(res1));
+        subject->GetObservable()->Buffer(3, 1)->Subscribe(collect(res2));
+        subject->GetObservable()->Buffer(2, 3)->Subscribe(collect(res3));
+
+        const auto batchSubject = std::make_shared<Subject<int>>();
+        batchSubject->GetObservable()->Buffer(2, 3)->Subscribe(collect(res4));
+
+        // 実行処理
+        const std::vector<int> values = {1, 2, 3, 4, 5, 6, 7};
+        for (auto v : values)
+        {
+            subject->OnNext(v);
+        }
+        subject->OnCompleted();
+        batchSubject->OnNextBatch(values.data(), values.size());
+        batchSubject->OnCompleted();
+
+        bool test1 = res1 == Buffers{{1, 2, 3}, {4, 5, 6}, {7}};
+        bool test2 = res2 == Buffers{{1, 2, 3}, {2, 3, 4}, {3, 4, 5}, {4, 5, 6}, {5, 6, 7}, {6, 7}, {7}};
+        bool test3 = res3 == Buffers{{1, 2}, {4, 5}, {7}};
+        bool test4 = res4 == res3;
+
+        return {test1 && test2 && test3 && test4, "BufferTest"};
+    }
+
+    // BufferFrame テスト
+    static TestResult BufferFrameTest()
+    {
+        std::vector<std::vector<int>> res;
+
+        const auto subject = std::make_shared<Subject<int>>();
+        auto d = subject->GetObservable()
+                        ->BufferFrame(2)
+                        ->Subscribe([&](const Span<int>& s) mutable
+                        {
+                            res.emplace_back(s.begin(), s.end());
+                        });
+
+        // 実行処理
+        subject->OnNext(1);
+        subject->OnNext(2);
+        ObservableUtil::DoEveryUpdate();
+        bool test1 = res.empty(); // 2フレーム経つまでは流れない
+
+        subject->OnNext(3);
+        ObservableUtil::DoEveryUpdate();
+        bool test2 = res == std::vector<std::vector<int>>{{1, 2, 3}};
+
+        ObservableUtil::DoEveryUpdate();
+        ObservableUtil::DoEveryUpdate();
+        bool test3 = res.size() == 1; // 何も受け取らなかった間は流れない
+
+        subject->OnNext(4);
+        d->Dispose();
+        ObservableUtil::DoEveryUpdate();
+        ObservableUtil::DoEveryUpdate();
+        bool test4 = res.size() == 1; // 廃棄後は流れない
+
+        return {test1 && test2 && test3 && test4, "BufferFrameTest"};
+    }
+
+    // Window テスト
+    static TestResult WindowTest()
+    {
+        std::vector<std::vector<int>> res;
+        int completed = 0;
+
+        const auto subject = std::make_shared<Subject<int>>();
+        subject->GetObservable()
+               ->Window(2)
+               ->Subscribe([&](const std::shared_ptr<Observable<int>>& window) mutable
+               {
+                   res.emplace_back();
+                   const auto index = res.size() - 1;
+                   window->Subscribe([&, index](int i) mutable { res[index].emplace_back(i); },
+                                     [&]() mutable { ++completed; });
+               });
+
+        // 実行処理
+        for (int i = 1; i <= 5; ++i)
+        {
+            subject->OnNext(i);
+        }
+        bool test1 = res == std::vector<std::vector<int>>{{1, 2}, {3, 4}, {5}} && completed == 2;
+
+        subject->OnCompleted();
+        bool test2 = completed == 3;
+
+        return {test1 && test2, "WindowTest"};
+    }
+
+    // OnBackpressureBuffer / Drop / Latest テスト
+    static TestResult BackpressureTest()
+    {
+        const auto subject = std::make_shared<Subject<int>>();
+
+        std::vector<int> buffered;
+        const auto bufferStats = std::make_shared<BackpressureStats>();
+        subject->GetObservable()
+               ->OnBackpressureBuffer(3, Scheduler::MainThread(), bufferStats)
+               ->Subscribe([&](int i) mutable { buffered.emplace_back(i); });
+
+        std::vector<int> dropped;
+        const auto dropStats = std::make_shared<BackpressureStats>();
+        subject->GetObservable()
+               ->OnBackpressureDrop(Scheduler::MainThread(), dropStats)
+               ->Subscribe([&](int i) mutable { dropped.emplace_back(i); });
+
+        std::vector<int> latest;
+        bool latestCompleted = false;
+        const auto latestStats = std::make_shared<BackpressureStats>();
+        subject->GetObservable()
+               ->OnBackpressureLatest(Scheduler::MainThread(), latestStats)
+               ->Subscribe([&](int i) mutable { latest.emplace_back(i); },
+                           [&]() mutable { latestCompleted = true; });
+
+        // 実行処理
+        for (int i = 1; i <= 5; ++i)
+        {
+            subject->OnNext(i);
+        }
+        bool test1 = buffered.empty() && dropped.empty() && latest.empty(); // DoEveryUpdateまでは届かない
+
+        ObservableUtil::DoEveryUpdate();
+        bool test2 = buffered == std::vector<int>{1, 2, 3} && bufferStats->Dropped() == 2;
+        bool test3 = dropped == std::vector<int>{1} && dropStats->Dropped() == 4;
+        bool test4 = latest == std::vector<int>{5} && latestStats->Dropped() == 4;
+
+        // 完了は溜まっている値の後に届く
+        subject->OnNext(6);
+        subject->OnNext(7);
+        subject->OnCompleted();
+        bool test5 = !latestCompleted;
+
+        ObservableUtil::DoEveryUpdate();
+        bool test6 = latest == std::vector<int>{5, 7} && latestCompleted;
+        bool test7 = buffered == std::vector<int>{1, 2, 3, 6, 7};
+
+        return {test1 && test2 && test3 && test4 && test5 && test6 && test7, "BackpressureTest"};
+    }
+
+    // 遅い購読者に対して OnBackpressureBuffer で捨てた数と届いた数が合うことのテスト
+    static TestResult BackpressureThreadPoolTest()
+    {
+        constexpr int count = 100000;
+        std::vector<int> res;
+        std::atomic<bool> completed{false};
+        const auto stats = std::make_shared<BackpressureStats>();
+
+        const auto subject = std::make_shared<Subject<int>>();
+        auto d = subject->GetObservable()
+                        ->OnBackpressureBuffer(64, Scheduler::ThreadPool(), stats)
+                        ->Subscribe([&](int i) mutable
+                                    {
+                                        res.emplace_back(i);
+                                        // 遅い購読者
+                                        volatile int spin = 0;
+                                        for (int j = 0; j < 200; ++j) spin = spin + j;
+                                    },
+                                    [&]() mutable
+                                    {
+                                        completed.store(true);
+                                    });
+
+        // 実行処理
+        for (int i = 0; i < count; i++)
+        {
+            subject->OnNext(i);
+        }
+        subject->OnCompleted();
+
+        while (!completed.load())
+        {
+            std::this_thread::yield();
+        }
+
+        bool test1 = static_cast<uint64_t>(res.size()) + stats->Dropped() == count;
+        bool test2 = stats->Dropped() > 0;
+        bool test3 = std::is_sorted(res.begin(), res.end()) && std::adjacent_find(res.begin(), res.end()) == res.end();
+
+        d->Dispose();
+        return {test1 && test2 && test3, "BackpressureThreadPoolTest"};
+    }
+
+    // ThrottleFirstFrame / ThrottleFrame / SampleFrame テスト
+    static TestResult ThrottleFrameTest()
+    {
+        const auto subject = std::make_shared<Subject<int>>();
+
+        std::vector<int> first;
+        subject->GetObservable()
+               ->ThrottleFirstFrame(3)
+               ->Subscribe([&](int i) mutable { first.emplace_back(i); });
+
+        std::vector<int> throttled;
+        bool throttleCompleted = false;
+        subject->GetObservable()
+               ->ThrottleFrame(2)
+               ->Subscribe([&](int i) mutable { throttled.emplace_back(i); },
+                           [&]() mutable { throttleCompleted = true; });
+
+        std::vector<int> sampled;
+        subject->GetObservable()
+               ->SampleFrame(2)
+               ->Subscribe([&](int i) mutable { sampled.emplace_back(i); });
+
+        // 実行処理
+        subject->OnNext(1);
+        subject->OnNext(2);
+        ObservableUtil::DoEveryUpdate();
+        bool test1 = first == std::vector<int>{1} && throttled.empty() && sampled.empty();
+
+        subject->OnNext(3); // 1フレーム後に届いたのでThrottleFrameは待ち直す
+        ObservableUtil::DoEveryUpdate();
+        bool test2 = first == std::vector<int>{1} && throttled.empty() && sampled == std::vector<int>{3};
+
+        ObservableUtil::DoEveryUpdate();
+        subject->OnNext(4); // ThrottleFirstFrameは3フレーム経ったので流す
+        bool test3 = first == std::vector<int>{1, 4} && throttled == std::vector<int>{3};
+
+        ObservableUtil::DoEveryUpdate();
+        bool test4 = sampled == std::vector<int>{3, 4};
+
+        ObservableUtil::DoEveryUpdate();
+        ObservableUtil::DoEveryUpdate();
+        bool test5 = sampled == std::vector<int>{3, 4}; // 何も届かなかった区間では流さない
+
+        // 完了時は待っている値を流してから完了する
+        subject->OnNext(5);
+        subject->OnCompleted();
+        bool test6 = throttled == std::vector<int>{3, 4, 5} && throttleCompleted;
+
+        // 廃棄後は流れない
+        const auto subject2 = std::make_shared<Subject<int>>();
+        std::vector<int> res;
+        auto d = subject2->GetObservable()
+                         ->ThrottleFrame(1)
+                         ->Subscribe([&](int i) mutable { res.emplace_back(i); });
+        subject2->OnNext(1);
+        d->Dispose();
+        ObservableUtil::DoEveryUpdate();
+        bool test7 = res.empty();
+
+        return {test1 && test2 && test3 && test4 && test5 && test6 && test7, "ThrottleFrameTest"};
+    }
+
+    // ThrottleFirst / Throttle / Sample (実時間) テスト
+    static TestResult ThrottleTimeTest()
+    {
+        const auto subject = std::make_shared<Subject<int>>();
+
+        std::vector<int> first;
+        subject->GetObservable()
+               ->ThrottleFirst(std::chrono::milliseconds(50))
+               ->Subscribe([&](int i) mutable { first.emplace_back(i); });
+
+        std::vector<int> throttled;
+        subject->GetObservable()
+               ->Throttle(std::chrono::milliseconds(100))
+               ->Subscribe([&](int i) mutable { throttled.emplace_back(i); });
+
+        std::vector<int> sampled;
+        subject->GetObservable()
+               ->Sample(std::chrono::milliseconds(100))
+               ->Subscribe([&](int i) mutable { sampled.emplace_back(i); });
+
+        // 実行処理
+        subject->OnNext(1);
+        subject->OnNext(2);
+        ObservableUtil::DoEveryUpdate();
+        bool test1 = first == std::vector<int>{1} && throttled.empty() && sampled.empty();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(120));
+        subject->OnNext(3);
+        bool test2 = first == std::vector<int>{1, 3};
+
+        ObservableUtil::DoEveryUpdate();
+        bool test3 = throttled.empty(); // 3が届いたので待ち直す
+        bool test4 = sampled == std::vector<int>{3};
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(120));
+        ObservableUtil::DoEveryUpdate();
+        bool test5 = throttled == std::vector<int>{3};
+
+        subject->OnCompleted();
+        return {test1 && test2 && test3 && test4 && test5, "ThrottleTimeTest"};
+    }
+
+    // DistinctUntilChanged テスト
+    static TestResult DistinctUntilChangedTest()
+    {
+        std::vector<int> res1;
+        std::vector<std::string> res2;
+        std::vector<int> res3;
+        std::vector<int> res4;
+
+        const auto subject = std::make_shared<Subject<int>>();
+        subject->GetObservable()
+               ->DistinctUntilChanged()
+               ->Subscribe([&](int i) mutable { res1.emplace_back(i); });
+
+        // 差が5未満なら同じとみなす
+        subject->GetObservable()
+               ->DistinctUntilChanged<int>([](const int& i) { return i; },
+                                           [](const int& a, const int& b) { return std::abs(a - b) < 5; })
+               ->Subscribe([&](int i) mutable { res3.emplace_back(i); });
+
+        // 長さが変わったときだけ流す
+        const auto strSubject = std::make_shared<Subject<std::string>>();
+        strSubject->GetObservable()
+                  ->DistinctUntilChanged<size_t>([](const std::string& str) { return str.size(); })
+                  ->Subscribe([&](const std::string& str) mutable { res2.emplace_back(str); });
+
+        // 実行処理
+        for (auto i : {0, 0, 3, 3, 10, 12, 12, 20, 0})
+        {
+            subject->OnNext(i);
+        }
+        for (auto str : {"a", "b", "cc", "dd", "e"})
+        {
+            strSubject->OnNext(str);
+        }
+        bool test1 = res1 == std::vector<int>{0, 3, 10, 12, 20, 0};
+        bool test2 = res2 == std::vector<std::string>{"a", "cc", "e"};
+        bool test3 = res3 == std::vector<int>{0, 10, 20, 0};
+
+        // まとめて流した場合も、バッチをまたいで直前の値と比べる
+        const auto batchSubject = std::make_shared<Subject<int>>();
+        batchSubject->GetObservable()
+                    ->DistinctUntilChanged()
+                    ->Subscribe([&](int i) mutable { res4.emplace_back(i); });
+        const int batch1[] = {1, 1, 2, 3, 3, 3, 4, 4};
+        const int batch2[] = {4, 4, 5};
+        batchSubject->OnNextBatch(batch1, 8);
+        batchSubject->OnNextBatch(batch2, 3);
+        bool test4 = res4 == std::vector<int>{1, 2, 3, 4, 5};
+
+        return {test1 && test2 && test3 && test4, "DistinctUntilChangedTest"};
+    }
+
+    // Merge テスト
+    static TestResult MergeTest()
+    {
+        std::vector<int> res;
+        bool completed = false;
+
+        const auto a = std::make_shared<Subject<int>>();
+        const auto b = std::make_shared<Subject<int>>();
+        const auto c = std::make_shared<Subject<int>>();
+        a->GetObservable()
+         ->Merge(b->GetObservable(), c->GetObservable()->Select<int>([](int i) { return i * 100; }))
+         ->Subscribe([&](int i) mutable { res.emplace_back(i); },
+                     [&]() mutable { completed = true; });
+
+        // 実行処理
+        a->OnNext(1);
+        b->OnNext(2);
+        c->OnNext(3);
+        a->OnNext(4);
+        bool test1 = res == std::vector<int>{1, 2, 300, 4};
+
+        a->OnCompleted();
+        b->OnCompleted();
+        b->OnNext(5);
+        bool test2 = !completed; // 全て完了するまでは完了しない
+
+        c->OnCompleted();
+        bool test3 = completed;
+
+        return {test1 && test2 && test3, "MergeTest"};
+    }
+
+    // CombineLatest テスト
+    static TestResult CombineLatestTest()
+    {
+        std::vector<std::tuple<int, std::string>> res;
+        bool completed = false;
+
+        const auto a = std::make_shared<Subject<int>>();
+        const auto b = std::make_shared<Subject<std::string>>();
+        a->GetObservable()
+         ->CombineLatest(b->GetObservable())
+         ->Subscribe([&](const std::tuple<int, std::string>& t) mutable { res.emplace_back(t); },
+                     [&]() mutable { completed = true; });
+
+        // 実行処理
+        a->OnNext(1);
+        bool test1 = res.empty(); // 全ての入力が揃うまでは流さない
+
+        b->OnNext("x");
+        a->OnNext(2);
+        b->OnNext("y");
+        bool test2 = res == std::vector<std::tuple<int, std::string>>{
+            std::make_tuple(1, "x"), std::make_tuple(2, "x"), std::make_tuple(2, "y")};
+
+        a->OnCompleted();
+        b->OnNext("z"); // 完了した入力は最後の値を使う
+        bool test3 = !completed && std::get<0>(res.back()) == 2 && std::get<1>(res.back()) == "z";
+
+        b->OnCompleted();
+        bool test4 = completed;
+
+        // 値を受け取らずに完了した入力があれば、もう流せないので完了する
+        bool completed2 = false;
+        const auto c = std::make_shared<Subject<int>>();
+        const auto d = std::make_shared<Subject<int>>();
+        c->GetObservable()
+         ->CombineLatest(d->GetObservable())
+         ->Subscribe([](const std::tuple<int, int>&) {}, [&]() mutable { completed2 = true; });
+        c->OnNext(1);
+        d->OnCompleted();
+        bool test5 = completed2;
+
+        return {test1 && test2 && test3 && test4 && test5, "CombineLatestTest"};
+    }
+
+    // Zip テスト
+    static TestResult ZipTest()
+    {
+        std::vector<std::tuple<int, int, std::string>> res;
+        bool completed = false;
+
+        const auto a = std::make_shared<Subject<int>>();
+        const auto b = std::make_shared<Subject<int>>();
+        const auto c = std::make_shared<Subject<std::string>>();
+        a->GetObservable()
+         ->Zip(b->GetObservable(), c->GetObservable())
+         ->Subscribe([&](const std::tuple<int, int, std::string>& t) mutable { res.emplace_back(t); },
+                     [&]() mutable { completed = true; });
+
+        // 実行処理
+        a->OnNext(1);
+        a->OnNext(2);
+        a->OnNext(3);
+        b->OnNext(10);
+        bool test1 = res.empty();
+
+        c->OnNext("x");
+        b->OnNext(20);
+        c->OnNext("y");
+        bool test2 = res == std::vector<std::tuple<int, int, std::string>>{
+            std::make_tuple(1, 10, "x"), std::make_tuple(2, 20, "y")};
+
+        a->OnCompleted();
+        bool test3 = !completed; // 溜まっている3がまだ組になれる
+
+        b->OnNext(30);
+        c->OnNext("z");
+        bool test4 = res.size() == 3 && std::get<0>(res.back()) == 3 && completed;
+
+        // 容量を超えて先行した分は受け取った値を捨てる
+        std::vector<std::tuple<int, int>> res2;
+        const auto e = std::make_shared<Subject<int>>();
+        const auto f = std::make_shared<Subject<int>>();
+        e->GetObservable()
+         ->Zip(2, f->GetObservable())
+         ->Subscribe([&](const std::tuple<int, int>& t) mutable { res2.emplace_back(t); });
+        e->OnNext(1);
+        e->OnNext(2);
+        e->OnNext(3);
+        f->OnNext(10);
+        bool test5 = res2 == std::vector<std::tuple<int, int>>{std::make_tuple(1, 10)};
+
+        // 購読後は値ごとに確保しない
+        const auto before = RxPool::GlobalAllocationCount();
+        for (int i = 0; i < 1000; ++i)
+        {
+            e->OnNext(i);
+            f->OnNext(i);
+        }
+        const auto after = RxPool::GlobalAllocationCount();
+        bool test6 = before == after && res2.size() == 1001 && std::get<0>(res2.back()) + 1 == std::get<1>(res2.back()); // eは1つ先行している
+
+        return {test1 && test2 && test3 && test4 && test5 && test6, "ZipTest"};
+    }
+
+    // BehaviorSubject テスト
+    static TestResult BehaviorSubjectTest()
+    {
+        std::vector<int> res1;
+        std::vector<int> res2;
+        bool completed = false;
+
+        const auto subject = std::make_shared<BehaviorSubject<int>>(0);
+        subject->GetObservable()
+               ->Subscribe([&](int i) mutable { res1.emplace_back(i); });
+
+        // 実行処理
+        bool test1 = res1 == std::vector<int>{0}; // 購読時に初期値が届く
+
+        subject->OnNext(1);
+        subject->GetObservable()
+               ->Subscribe([&](int i) mutable { res2.emplace_back(i); });
+        subject->OnNext(2);
+        bool test2 = res1 == std::vector<int>{0, 1, 2} && res2 == std::vector<int>{1, 2} && subject->Value() == 2;
+
+        // 完了後の購読には完了だけが届く
+        subject->OnCompleted();
+        std::vector<int> res3;
+        subject->GetObservable()
+               ->Subscribe([&](int i) mutable { res3.emplace_back(i); },
+                           [&]() mutable { completed = true; });
+        bool test3 = res3.empty() && completed;
+
+        return {test1 && test2 && test3, "BehaviorSubjectTest"};
+    }
+
+    // ReplaySubject テスト
+    static TestResult ReplaySubjectTest()
+    {
+        // 直近の個数で区切る
+        const auto subject = std::make_shared<ReplaySubject<int>>(3);
+        for (int i = 1; i <= 5; ++i)
+        {
+            subject->OnNext(i);
+        }
+
+        std::vector<int> res1;
+        subject->GetObservable()
+               ->Where([](int i) { return i % 2 == 1; })
+               ->Subscribe([&](int i) mutable { res1.emplace_back(i); });
+        subject->OnNext(7);
+        bool test1 = res1 == std::vector<int>{3, 5, 7};
+
+        subject->OnCompleted();
+        std::vector<int> res2;
+        bool completed = false;
+        subject->GetObservable()
+               ->Subscribe([&](int i) mutable { res2.emplace_back(i); },
+                           [&]() mutable { completed = true; });
+        bool test2 = res2 == std::vector<int>{4, 5, 7} && completed;
+
+        // まとめて流した場合も容量分だけ溜める
+        const auto batchSubject = std::make_shared<ReplaySubject<int>>(2);
+        const int batch[] = {1, 2, 3, 4, 5};
+        batchSubject->OnNextBatch(batch, 5);
+        std::vector<int> res3;
+        batchSubject->GetObservable()
+                    ->Subscribe([&](int i) mutable { res3.emplace_back(i); });
+        bool test3 = res3 == std::vector<int>{4, 5};
+
+        // 直近のフレーム数で区切る
+        const auto frameSubject = std::make_shared<ReplaySubject<int>>(ReplaySubject<int>::FrameWindow{2});
+        const auto replay = [&]
+        {
+            std::vector<int> res;
+            frameSubject->GetObservable()
+                        ->Subscribe([&](int i) mutable { res.emplace_back(i); })
+                        ->Dispose();
+            return res;
+        };
+        frameSubject->OnNext(1);
+        ObservableUtil::DoEveryUpdate();
+        frameSubject->OnNext(2);
+        bool test4 = replay() == std::vector<int>{1, 2};
+
+        ObservableUtil::DoEveryUpdate();
+        bool test5 = replay() == std::vector<int>{2};
+
+        ObservableUtil::DoEveryUpdate();
+        bool test6 = replay().empty() && frameSubject->Size() == 0;
+
+        // フレーム数で区切る場合も上限を超えたら古いものから捨てる
+        const auto cappedSubject = std::make_shared<ReplaySubject<int>>(ReplaySubject<int>::FrameWindow{100}, 2);
+        cappedSubject->OnNext(1);
+        cappedSubject->OnNext(2);
+        cappedSubject->OnNext(3);
+        bool test7 = cappedSubject->Size() == 2;
+
+        // 溜める数が0なら何も再生せず、以降の値だけ流す
+        const auto emptySubject = std::make_shared<ReplaySubject<int>>(0);
+        emptySubject->OnNext(1);
+        emptySubject->OnNextBatch(batch, 5);
+        std::vector<int> res4;
+        emptySubject->GetObservable()
+                    ->Subscribe([&](int i) mutable { res4.emplace_back(i); });
+        bool test8 = res4.empty() && emptySubject->Size() == 0;
+
+        emptySubject->OnNext(6);
+        bool test9 = res4 == std::vector<int>{6};
+
+        return {test1 && test2 && test3 && test4 && test5 && test6 && test7 && test8 && test9, "ReplaySubjectTest"};
+    }
+
+    // 廃棄後に同じObservableから購読し直した場合も廃棄できることのテスト
+    static TestResult ResubscribeAfterDisposeTest()
+    {
+        std::vector<int> res;
+
+        const auto subject = std::make_shared<Subject<int>>();
+        const auto o = subject->GetObservable();
+        o->Subscribe([&](int i) mutable { res.emplace_back(i); })->Dispose();
+
+        // 実行処理
+        auto d = o->Subscribe([&](int i) mutable { res.emplace_back(i * 10); });
+        subject->OnNext(1);
+        bool test1 = res == std::vector<int>{10};
+
+        d->Dispose();
+        subject->OnNext(2);
+        bool test2 = res == std::vector<int>{10};
+
+        return {test1 && test2, "ResubscribeAfterDisposeTest"};
+    }
+
+    // Publish / Connect テスト
+    static TestResult PublishTest()
+    {
+        int evaluated = 0;
+        std::vector<int> res;
+        int completed = 0;
+
+        const auto subject = std::make_shared<Subject<int>>();
+        const auto published = subject->GetObservable()
+                                      ->Select<int>([&](int i) mutable
+                                      {
+                                          ++evaluated;
+                                          return i * 2;
+                                      })
+                                      ->Publish();
+        for (int i = 0; i < 3; ++i)
+        {
+            published->Subscribe([&](int v) mutable { res.emplace_back(v); },
+                                 [&]() mutable { ++completed; });
+        }
+
+        // 実行処理
+        subject->OnNext(1);
+        bool test1 = evaluated == 0 && res.empty(); // 接続するまでは流れない
+
+        auto connection = published->Connect();
+        subject->OnNext(2);
+        bool test2 = evaluated == 1 && res == std::vector<int>{4, 4, 4}; // 上流は1回だけ評価される
+
+        connection->Dispose();
+        subject->OnNext(3);
+        bool test3 = evaluated == 1 && !published->IsConnected();
+
+        // 切断後に接続し直せる
+        published->Connect();
+        subject->OnNext(4);
+        subject->OnCompleted();
+        bool test4 = evaluated == 2 && res.size() == 6 && res.back() == 8 && completed == 3;
+
+        return {test1 && test2 && test3 && test4, "PublishTest"};
+    }
+
+    // Share (Publish + RefCount) テスト
+    static TestResult ShareTest()
+    {
+        int evaluated = 0;
+        std::vector<int> res1;
+        std::vector<int> res2;
+
+        const auto subject = std::make_shared<Subject<int>>();
+        const auto shared = subject->GetObservable()
+                                   ->Select<int>([&](int i) mutable
+                                   {
+                                       ++evaluated;
+                                       return i * 2;
+                                   })
+                                   ->Share();
+
+        // 実行処理
+        subject->OnNext(1);
+        bool test1 = evaluated == 0; // 購読者がいない間は接続しない
+
+        auto d1 = shared->Subscribe([&](int v) mutable { res1.emplace_back(v); });
+        auto d2 = shared->Subscribe([&](int v) mutable { res2.emplace_back(v); });
+        subject->OnNext(2);
+        bool test2 = evaluated == 1 && res1 == std::vector<int>{4} && res2 == std::vector<int>{4};
+
+        // 購読は個別に廃棄できる
+        d1->Dispose();
+        subject->OnNext(3);
+        bool test3 = evaluated == 2 && res1.size() == 1 && res2 == std::vector<int>{4, 6};
+
+        // 全て廃棄したら切断する
+        d2->Dispose();
+        subject->OnNext(4);
+        bool test4 = evaluated == 2;
+
+        // 購読し直すと接続し直す
+        std::vector<int> res3;
+        shared->Take(2)->Subscribe([&](int v) mutable { res3.emplace_back(v); });
+        subject->OnNext(5);
+        subject->OnNext(6);
+        subject->OnNext(7); // Take(2)で廃棄されたので切断済み
+        bool test5 = evaluated == 4 && res3 == std::vector<int>{10, 12};
+
+        return {test1 && test2 && test3 && test4 && test5, "ShareTest"};
+    }
+
+#if RX_COROUTINES
+    static Task FrameCountTask(std::vector<uint64_t>& frames)
+    {
+        frames.emplace_back(FrameTimerWheel::Main().Frame());
+        co_await NextFrame();
+        frames.emplace_back(FrameTimerWheel::Main().Frame());
+        co_await Frames(3);
+        frames.emplace_back(FrameTimerWheel::Main().Frame());
+        co_await Frames(0); // 待たない
+        frames.emplace_back(FrameTimerWheel::Main().Frame());
+    }
+
+    // Coroutine Frames テスト
+    static TestResult CoroutineFramesTest()
+    {
+        std::vector<uint64_t> frames;
+        const auto start = FrameTimerWheel::Main().Frame();
+
+        // 実行処理
+        auto task = FrameCountTask(frames);
+        bool test1 = frames == std::vector<uint64_t>{start} && !task.IsDone(); // 最初のco_awaitまではその場で実行
+
+        ObservableUtil::DoEveryUpdate();
+        bool test2 = frames == std::vector<uint64_t>{start, start + 1};
+
+        ObservableUtil::DoEveryUpdate();
+        ObservableUtil::DoEveryUpdate();
+        bool test3 = frames.size() == 2;
+
+        ObservableUtil::DoEveryUpdate();
+        bool test4 = frames == std::vector<uint64_t>{start, start + 1, start + 4, start + 4} && task.IsDone();
+
+        return {test1 && test2 && test3 && test4, "CoroutineFramesTest"};
+    }
+
+    static Task FirstAsyncTask(std::shared_ptr<Observable<int>> source, std::vector<int>& res, bool& finished)
+    {
+        res.emplace_back(co_await source->FirstAsync());
+        res.emplace_back(co_await source->FirstAsync());
+        finished = true;
+    }
+
+    // FirstAsync テスト
+    static TestResult FirstAsyncTest()
+    {
+        // 値が来るまで待つ
+        std::vector<int> res1;
+        bool finished1 = false;
+        const auto subject = std::make_shared<Subject<int>>();
+        auto task1 = FirstAsyncTask(subject->GetObservable(), res1, finished1);
+        bool test1 = res1.empty() && !task1.IsDone();
+
+        subject->OnNext(1);
+        bool test2 = res1 == std::vector<int>{1} && !finished1;
+
+        subject->OnNext(2);
+        subject->OnNext(3); // 待ち終わっているので受け取らない
+        bool test3 = res1 == std::vector<int>{1, 2} && finished1 && task1.IsDone();
+
+        // 購読時に値が流れてくる場合は中断せずに続ける
+        std::vector<int> res2;
+        bool finished2 = false;
+        BehaviorSubject<int> behavior(5);
+        auto task2 = FirstAsyncTask(behavior.GetObservable(), res2, finished2);
+        bool test4 = res2 == std::vector<int>{5, 5} && finished2 && task2.IsDone();
+
+        // 値が来ないまま完了したらタスクを中断する
+        std::vector<int> res3;
+        bool finished3 = false;
+        const auto subject3 = std::make_shared<Subject<int>>();
+        auto task3 = FirstAsyncTask(subject3->GetObservable(), res3, finished3);
+        subject3->OnNext(7);
+        subject3->OnCompleted();
+        bool test5 = res3 == std::vector<int>{7} && !finished3 && task3.IsDone();
+
+        // 同じObservableを複数のタスクで同時に待っても、先に受け取ったタスクの廃棄で他の待ちは外れない
+        std::vector<int> res4;
+        std::vector<int> res5;
+        bool finished4 = false;
+        bool finished5 = false;
+        const auto subject4 = std::make_shared<Subject<int>>();
+        const auto observable4 = subject4->GetObservable();
+        auto task4 = FirstAsyncTask(observable4, res4, finished4);
+        auto task5 = FirstAsyncTask(observable4, res5, finished5);
+        subject4->OnNext(1);
+        subject4->OnNext(2);
+        bool test6 = res4 == std::vector<int>{1, 2} && res5 == std::vector<int>{1, 2} && finished4 && finished5;
+
+        // ConcurrentSubjectも同様
+        std::vector<int> res6;
+        std::vector<int> res7;
+        bool finished6 = false;
+        bool finished7 = false;
+        ConcurrentSubject<int> concurrent;
+        const auto observable6 = concurrent.GetObservable();
+        auto task6 = FirstAsyncTask(observable6, res6, finished6);
+        auto task7 = FirstAsyncTask(observable6, res7, finished7);
+        concurrent.OnNext(1);
+        concurrent.OnNext(2);
+        bool test7 = res6 == std::vector<int>{1, 2} && res7 == std::vector<int>{1, 2} && finished6 && finished7;
+
+        return {test1 && test2 && test3 && test4 && test5 && test6 && test7, "FirstAsyncTest"};
+    }
+
+    static Task CancelTask(std::shared_ptr<Disposable>& self, bool& reached, bool& after)
+    {
+        co_await NextFrame();
+        self->Dispose(); // 実行中に自身を廃棄
+        reached = true;
+        co_await NextFrame();
+        after = true;
+    }
+
+    // Coroutine キャンセル テスト
+    static TestResult CoroutineCancelTest()
+    {
+        // 待機中にDisposeするとタイマーごと破棄される
+        std::vector<uint64_t> frames;
+        const auto count = FrameTimerWheel::Main().Count();
+        auto task1 = FrameCountTask(frames);
+        bool test1 = FrameTimerWheel::Main().Count() == count + 1;
+
+        task1.GetDisposable()->Dispose();
+        bool test2 = task1.IsDone() && FrameTimerWheel::Main().Count() == count;
+
+        ObservableUtil::DoEveryUpdate();
+        bool test3 = frames.size() == 1;
+
+        // 実行中にDisposeした場合は次に中断した時点で破棄される
+        std::shared_ptr<Disposable> self;
+        bool reached = false;
+        bool after = false;
+        auto task2 = CancelTask(self, reached, after);
+        self = task2.GetDisposable();
+
+        ObservableUtil::DoEveryUpdate();
+        bool test4 = reached && task2.IsDone() && FrameTimerWheel::Main().Count() == count;
+
+        ObservableUtil::DoEveryUpdate();
+        bool test5 = !after;
+
+        // FirstAsyncで待機中に廃棄すると購読も廃棄される
+        std::vector<int> res;
+        bool finished = false;
+        const auto subject = std::make_shared<Subject<int>>();
+        auto task3 = FirstAsyncTask(subject->GetObservable(), res, finished);
+        task3.GetDisposable()->Dispose();
+        subject->OnNext(1);
+        bool test6 = res.empty() && task3.IsDone();
+
+        return {test1 && test2 && test3 && test4 && test5 && test6, "CoroutineCancelTest"};
+    }
+
+    static Task NextFrameTask()
+    {
+        co_await NextFrame();
+    }
+
+    // Coroutine フレームのプール確保 テスト
+    static TestResult CoroutinePoolTest()
+    {
+        constexpr int count = 1000;
+
+        // 1回目でプールを温めておく
+        for (int i = 0; i < count; ++i) NextFrameTask();
+        ObservableUtil::DoEveryUpdate();
+
+        // 2回目はプールを使い回すので大域アロケータを呼ばない
+        const auto before = RxPool::GlobalAllocationCount();
+        for (int i = 0; i < count; ++i) NextFrameTask();
+        ObservableUtil::DoEveryUpdate();
+        bool test1 = RxPool::GlobalAllocationCount() == before;
+
+        return {test1, "CoroutinePoolTest"};
+    }
+#endif
+
+    // Subject 並列配信 テスト
+    static TestResult ParallelDispatchTest()
+    {
+        constexpr int count = 1000;
+        std::vector<int> res(count, 0); // 購読者ごとに別の要素にだけ書き込む
+        std::vector<int> serial;
+        std::vector<std::shared_ptr<Disposable>> disposers(count);
+
+        const auto pool = std::make_shared<ThreadPoolScheduler>(4);
+        const auto subject = std::make_shared<Subject<int>>();
+        subject->SetParallelDispatch(pool, 16);
+
+        for (int i = 0; i < count; ++i)
+        {
+            disposers[i] = subject->GetIndependentObservable()->Subscribe([&res, &disposers, i](int v)
+            {
+                res[i] += v;
+                // 奇数番目は2回目で自身を廃棄 (配信後にまとめて廃棄される)
+                if (i % 2 == 1 && res[i] >= 2) disposers[i]->Dispose();
+            });
+        }
+        auto _ = subject->GetObservable()->Subscribe([&](int v) mutable { serial.emplace_back(v); });
+
+        // 実行処理
+        subject->OnNext(1);
+        bool test1 = std::all_of(res.begin(), res.end(), [](int v) { return v == 1; }) && serial == std::vector<int>{1};
+
+        subject->OnNext(1);
+        subject->OnNext(1);
+        bool test2 = true;
+        for (int i = 0; i < count; ++i)
+        {
+            test2 = test2 && res[i] == (i % 2 == 1 ? 2 : 3);
+        }
+        test2 = test2 && serial == std::vector<int>{1, 1, 1};
+
+        // まとめて流した場合も並列に配信される
+        const int values[] = {10, 20};
+        subject->OnNextBatch(values, 2);
+        bool test3 = res[0] == 33 && res[1] == 2;
+
+        // 逐次に戻す
+        subject->SetParallelDispatch(nullptr);
+        subject->OnNext(1);
+        bool test4 = res[0] == 34 && res[1] == 2;
+
+        for (auto&& d : disposers)
+        {
+            d->Dispose();
+        }
+
+        // ワーカーが埋まっていても呼び出し元だけで配信を終える。配信ごとに確保せず、
+        // 遅れて起動したワーカーはSubjectが破棄された後でも何もせずに終わる
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool released = false;
+        std::atomic<int> blocked{0};
+        auto busyPool = std::make_shared<ThreadPoolScheduler>(2);
+        for (int i = 0; i < 2; ++i)
+        {
+            busyPool->Schedule([&]
+            {
+                ++blocked;
+                std::unique_lock<std::mutex> lock(mutex);
+                condition.wait(lock, [&] { return released; });
+            });
+        }
+        while (blocked.load() < 2)
+        {
+            std::this_thread::yield();
+        }
+
+        std::vector<int> late(64, 0);
+        auto lateSubject = std::make_shared<Subject<int>>();
+        lateSubject->SetParallelDispatch(busyPool, 1);
+        for (int i = 0; i < 64; ++i)
+        {
+            auto __ = lateSubject->GetIndependentObservable()->Subscribe([&late, i](int v) { late[i] += v; });
+        }
+        lateSubject->OnNext(1);
+        const auto before = RxPool::ThreadAllocationCount();
+        lateSubject->OnNext(1);
+        bool test5 = RxPool::ThreadAllocationCount() == before
+                     && std::all_of(late.begin(), late.end(), [](int v) { return v == 2; });
+
+        lateSubject.reset();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            released = true;
+        }
+        condition.notify_all();
+        busyPool.reset(); // 溜まっていたワーカーの処理を全て実行してから終わる
+
+        return {test1 && test2 && test3 && test4 && test5, "ParallelDispatchTest"};
+    }
+
+    // Function 内部保持 テスト
+    static TestResult FunctionInlineTest()
+    {
+        // 小さな処理はプールから確保せずに内部に置く
+        int counter = 0;
+        auto before = RxPool::ThreadAllocationCount();
+        Function<void(int)> small = [&counter](int v) { counter += v; };
+        auto moved = std::move(small);
+        moved(2);
+        bool test1 = RxPool::ThreadAllocationCount() == before && small == nullptr && counter == 2;
+
+        // 大きな処理はプールから確保し、ムーブでは確保しない
+        std::array<int, 16> big{};
+        big[15] = 5;
+        Function<int()> large = [big] { return big[15]; };
+        before = RxPool::ThreadAllocationCount();
+        auto movedLarge = std::move(large);
+        bool test2 = RxPool::ThreadAllocationCount() == before && movedLarge() == 5 && large == nullptr;
+
+        // コピーはそれぞれ別の状態を持つ
+        Function<int()> count = [n = 0]() mutable { return ++n; };
+        count();
+        auto copied = count;
+        bool test3 = count() == 2 && copied() == 2 && count() == 3;
+
+        // 完了時の処理を渡さずに購読しても完了できる
+        bool received = false;
+        const auto subject = std::make_shared<Subject<int>>();
+        auto _ = subject->GetObservable()->Subscribe([&](int) mutable { received = true; });
+        subject->OnNext(1);
+        subject->OnCompleted();
+        bool test4 = received;
+
+        return {test1 && test2 && test3 && test4, "FunctionInlineTest"};
+    }
+
+    // オペレータの下流の保持 テスト
+    static TestResult DownstreamOwnershipTest()
+    {
+        int res = 0;
+        const auto subject = std::make_shared<Subject<int>>();
+        auto observer = std::make_shared<Observer<int>>([&](int v) mutable { res = v; }, nullptr);
+
+        auto d = subject->GetObservable()
+                        ->Where([](int v) { return v > 0; })
+                        ->Select<int>([](int v) { return v * 2; })
+                        ->Subscribe(observer);
+
+        // 下流は直前のオペレータのObserverが1つだけ保持する
+        bool test1 = observer.use_count() == 2;
+
+        // 実行処理
+        subject->OnNext(3);
+        bool test2 = res == 6;
+
+        // 廃棄すると解放される (廃棄予定は次の通知で掃除される)
+        d->Dispose();
+        subject->OnNext(4);
+        bool test3 = observer.use_count() == 1 && res == 6;
+
+        return {test1 && test2 && test3, "DownstreamOwnershipTest"};
+    }
+
+    // Record/Replay テスト
+    static TestResult RecordReplayTest()
+    {
+        const std::string path = "rx_test_eventlog.bin";
+        std::vector<int> passed;
+
+        // 記録 (値はそのまま下流へ流れる)
+        const auto subject = std::make_shared<Subject<int>>();
+        const auto writer = std::make_shared<EventLogWriter>(path, static_cast<uint32_t>(sizeof(int)));
+        auto d = subject->GetObservable()
+                        ->Record(writer)
+                        ->Subscribe([&](int v) mutable { passed.emplace_back(v); });
+
+        const auto start = FrameTimerWheel::Main().Frame();
+        subject->OnNext(1);
+        subject->OnNext(2);
+        ObservableUtil::DoEveryUpdate();
+        ObservableUtil::DoEveryUpdate();
+        const int batch[] = {3, 4};
+        subject->OnNextBatch(batch, 2);
+        d->Dispose();
+        writer->Close();
+        bool test1 = passed == std::vector<int>{1, 2, 3, 4};
+
+        // 読み込み
+        const auto records = ReadEventLog<int>(path);
+        bool test2 = records.size() == 4 &&
+                     records[0].value == 1 && records[0].frame == start &&
+                     records[1].value == 2 && records[1].frame == start &&
+                     records[2].value == 3 && records[2].frame == start + 2 &&
+                     records[3].value == 4 && records[3].frame == start + 2 &&
+                     records[0].timeNs <= records[3].timeNs;
+
+        // その場で全て流し直す
+        std::vector<int> fast;
+        const auto target = std::make_shared<Subject<int>>();
+        auto _ = target->GetObservable()->Subscribe([&](int v) mutable { fast.emplace_back(v); });
+        Replay(path, target, ReplayMode::AsFastAsPossible);
+        bool test3 = fast == std::vector<int>{1, 2, 3, 4};
+
+        // 記録時のフレーム間隔で流し直す
+        std::vector<int> paced;
+        const auto pacedTarget = std::make_shared<Subject<int>>();
+        auto __ = pacedTarget->GetObservable()->Subscribe([&](int v) mutable { paced.emplace_back(v); });
+        auto replaying = Replay(path, pacedTarget, ReplayMode::FramePaced);
+        bool test4 = paced.empty();
+
+        ObservableUtil::DoEveryUpdate();
+        bool test5 = paced == std::vector<int>{1, 2};
+
+        ObservableUtil::DoEveryUpdate();
+        bool test6 = paced.size() == 2;
+
+        ObservableUtil::DoEveryUpdate();
+        bool test7 = paced == std::vector<int>{1, 2, 3, 4} && replaying->IsDisposed();
+
+        // 値のサイズが違うログは読めない
+        bool test8 = false;
+        try
+        {
+            ReadEventLog<double>(path);
+        }
+        catch (const std::runtime_error&)
+        {
+            test8 = true;
+        }
+
+        // 既定コンストラクタの無い値も読み込める
+        struct Point
+        {
+            Point(int x, int y): x(x), y(y) {}
+            int x;
+            int y;
+        };
+        {
+            const auto points = std::make_shared<Subject<Point>>();
+            auto recording = points->GetObservable()->Record(path)->Subscribe([](const Point&) {});
+            points->OnNext(Point(1, 2));
+            points->OnNext(Point(3, 4));
+        }
+        std::vector<int> replayed;
+        const auto pointTarget = std::make_shared<Subject<Point>>();
+        auto ___ = pointTarget->GetObservable()->Subscribe([&](const Point& p) mutable { replayed.emplace_back(p.x * 10 + p.y); });
+        Replay(path, pointTarget, ReplayMode::AsFastAsPossible);
+        const auto pointRecords = ReadEventLog<Point>(path);
+        bool test9 = replayed == std::vector<int>{12, 34} &&
+                     pointRecords.size() == 2 && pointRecords[1].value.x == 3 && pointRecords[1].value.y == 4;
+
+        std::remove(path.c_str());
+
+        return {test1 && test2 && test3 && test4 && test5 && test6 && test7 && test8 && test9, "RecordReplayTest"};
+    }
+
+    // MappedFile テスト
+    static TestResult MappedFileTest()
+    {
+        struct Record
+        {
+            int id;
+            float value;
+        };
+
+        const std::string path = "rx_test_mapped.bin";
+        constexpr int count = 10000;
+        {
+            auto f = std::fopen(path.c_str(), "wb");
+            for (int i = 0; i < count; ++i)
+            {
+                const Record r{i, i * 0.5f};
+                std::fwrite(&r, sizeof(r), 1, f);
+            }
+            std::fclose(f);
+        }
+
+        // マップした領域をそのまま参照して流す
+        const auto file = std::make_shared<MappedFile>(path);
+        const auto* begin = reinterpret_cast<const Record*>(file->Data());
+        bool zeroCopy = true;
+        size_t batches = 0;
+        auto _ = ObservableUtil::FromMappedFile<Record>(file, 0, 1000)
+            ->Subscribe(std::make_shared<Observer<Record>>(
+                [](const Record&) {},
+                nullptr,
+                [&](const Record* data, size_t n) mutable
+                {
+                    if (data != begin + batches * 1000 || n != 1000) zeroCopy = false;
+                    ++batches;
+                }));
+        bool test1 = zeroCopy && batches == 10;
+
+        // Where/Selectを通す (まとめて流す場合と1件ずつ流す場合で同じ結果になる)
+        auto sumOf = [&](size_t chunkSize)
+        {
+            long long sum = 0;
+            bool completed = false;
+            auto d = ObservableUtil::FromMappedFile<Record>(path, 0, chunkSize)
+                ->Where([](const Record& r) { return r.id % 2 == 0; })
+                ->Select<long long>([](const Record& r) { return static_cast<long long>(r.value * 2); })
+                ->Subscribe([&](long long v) mutable { sum += v; }, [&] { completed = true; });
+            return completed ? sum : -1;
+        };
+        long long expected = 0;
+        for (int i = 0; i < count; i += 2) expected += i;
+        bool test2 = sumOf(ObservableUtil::DefaultMappedChunkSize) == expected;
+        bool test3 = sumOf(0) == expected;
+
+        // Takeで廃棄されたら残りは流さない。同じObservableから購読し直せる
+        const auto source = ObservableUtil::FromMappedFile<Record>(file, 0, 0);
+        int taken = 0;
+        int last = -1;
+        auto d = source->Take(3)->Subscribe([&](const Record& r) mutable
+        {
+            ++taken;
+            last = r.id;
+        });
+        bool test4 = taken == 3 && last == 2 && d->IsDisposed();
+
+        // 購読中(Subscribeが戻る前)に下流のTakeで廃棄されたら、上流も読むのを止める
+        // 1件ずつ流す場合はTakeに必要な分だけ、まとめて流す場合は最初のチャンクだけ読む
+        const auto readsUntilTake = [&](size_t chunkSize, bool pipe)
+        {
+            int reads = 0;
+            std::vector<int> ids;
+            int completedCount = 0;
+            const auto mapped = ObservableUtil::FromMappedFile<Record>(file, 0, chunkSize);
+            const auto where = [&](const Record& r) mutable
+            {
+                ++reads;
+                return r.id % 2 == 0;
+            };
+            const auto onNext = [&](const Record& r) mutable { ids.emplace_back(r.id); };
+            const auto onCompleted = [&]() mutable { completedCount++; };
+            auto sub = pipe ? mapped->Pipe(PipeOp::Where(where), PipeOp::Take(3))->Subscribe(onNext, onCompleted)
+                            : mapped->Where(where)->Take(3)->Subscribe(onNext, onCompleted);
+            return ids == std::vector<int>{0, 2, 4} && completedCount == 1 ? reads : -1;
+        };
+        test4 = test4 && readsUntilTake(0, false) == 5 && readsUntilTake(1000, false) == 1000 &&
+                readsUntilTake(0, true) == 5 && readsUntilTake(1000, true) == 5;
+
+        int again = 0;
+        auto __ = source->Subscribe([&](const Record&) mutable { ++again; });
+        bool test5 = again == count && !__->IsDisposed();
+
+        // Observable全体を廃棄した後の購読には流さない
+        source->GetDisposable()->Dispose();
+        auto late = source->Subscribe([&](const Record&) mutable { ++again; });
+        test5 = test5 && again == count && late->IsDisposed();
+
+        // ヘッダ分ずらして読む
+        int first = -1;
+        auto ___ = ObservableUtil::FromMappedFile<Record>(file, sizeof(Record) * 2)
+            ->Take(1)
+            ->Subscribe([&](const Record& r) mutable { first = r.id; });
+        bool test6 = first == 2;
+
+        // アラインメントが合わない/ファイルが無い場合は例外
+        bool test7 = false;
+        try
+        {
+            ObservableUtil::FromMappedFile<Record>(file, 1);
+        }
+        catch (const std::runtime_error&)
+        {
+            test7 = true;
+        }
+
+        bool test8 = false;
+        try
+        {
+            ObservableUtil::FromMappedFile<Record>("rx_test_missing.bin");
+        }
+        catch (const std::runtime_error&)
+        {
+            test8 = true;
+        }
+
+        // 記録したイベントログもコピーせずに読める (EventRecordに末尾のパディングが無い型の場合)
+        const std::string logPath = "rx_test_mapped_log.bin";
+        {
+            EventLogWriter writer(logPath, static_cast<uint32_t>(sizeof(double)));
+            const double values[] = {5, 6, 7};
+            writer.Append(42, values, 3);
+        }
+        std::vector<double> logged;
+        uint64_t frame = 0;
+        auto ____ = ObservableUtil::FromMappedFile<EventRecord<double>>(logPath, EventLogHeaderSize)
+            ->Subscribe([&](const EventRecord<double>& r) mutable
+            {
+                logged.emplace_back(r.value);
+                frame = r.frame;
+            });
+        bool test9 = logged == std::vector<double>{5, 6, 7} && frame == 42;
+
+        std::remove(logPath.c_str());
+        std::remove(path.c_str());
+
+        return {test1 && test2 && test3 && test4 && test5 && test6 && test7 && test8 && test9, "MappedFileTest"};
+    }
+
+    // 廃棄後も購読した順に通知されることのテスト
+    static TestResult SubscriptionOrderTest()
+    {
+        std::vector<int> order;
+
+        const auto subject = std::make_shared<Subject<int>>();
+        std::vector<std::shared_ptr<Disposable>> disposers;
+        for (int i = 0; i < 5; i++)
+        {
+            disposers.emplace_back(subject->GetObservable()->Subscribe([&order, i](int) mutable { order.emplace_back(i); }));
+        }
+
+        // 先頭と途中を廃棄し、後から1つ追加する
+        disposers[0]->Dispose();
+        disposers[2]->Dispose();
+        disposers.emplace_back(subject->GetObservable()->Subscribe([&order](int) mutable { order.emplace_back(5); }));
+
+        subject->OnNext(0);
+        bool test1 = order == std::vector<int>{1, 3, 4, 5};
+
+        // 通知中の廃棄でも残りの並びは変わらない
+        order.clear();
+        disposers.emplace_back(subject->GetObservable()->Subscribe([&](int) mutable
+        {
+            order.emplace_back(6);
+            disposers[3]->Dispose();
+        }));
+        subject->OnNext(0);
+        bool test2 = order == std::vector<int>{1, 3, 4, 5, 6};
+
+        order.clear();
+        subject->OnNext(0);
+        bool test3 = order == std::vector<int>{1, 4, 5, 6};
+
+        return {test1 && test2 && test3, "SubscriptionOrderTest"};
+    }
+
+    // バッチの途中で廃棄した場合、残りの値は流れないことのテスト
+    static TestResult BatchDisposeTest()
+    {
+        const int batch[] = {1, 2, 3, 4, 5};
+
+        // 直接購読 (Observerの既定の1つずつの処理)
+        std::vector<int> direct;
+        const auto subject = std::make_shared<Subject<int>>();
+        static std::shared_ptr<Disposable> d1;
+        d1 = subject->GetObservable()->Subscribe([&](int v) mutable
+        {
+            direct.emplace_back(v);
+            if (v == 2) d1->Dispose();
+        });
+        subject->OnNextBatch(batch, 5);
+        bool test1 = direct == std::vector<int>{1, 2};
+
+        // まとめて受け取れるオペレータの先で1つずつに分けた場合
+        std::vector<int> chained;
+        static std::shared_ptr<Disposable> d2;
+        d2 = subject->GetObservable()
+                    ->Where([](int v) { return v != 3; })
+                    ->Select<int>([](int v) { return v * 10; })
+                    ->Subscribe([&](int v) mutable
+                    {
+                        chained.emplace_back(v);
+                        if (v == 40) d2->Dispose();
+                    });
+        subject->OnNextBatch(batch, 5);
+        bool test2 = chained == std::vector<int>{10, 20, 40};
+
+        // 他の購読者には最後まで流れる
+        std::vector<int> other;
+        auto d3 = subject->GetObservable()->Subscribe([&](int v) mutable { other.emplace_back(v); });
+        static std::shared_ptr<Disposable> d4;
+        std::vector<int> disposed;
+        d4 = subject->GetObservable()->Subscribe([&](int v) mutable
+        {
+            disposed.emplace_back(v);
+            d4->Dispose();
+        });
+        subject->OnNextBatch(batch, 5);
+        bool test3 = other == std::vector<int>{1, 2, 3, 4, 5} && disposed == std::vector<int>{1};
+
+        // ConcurrentSubjectも同様
+        std::vector<int> concurrent;
+        ConcurrentSubject<int> cs;
+        static std::shared_ptr<Disposable> d5;
+        d5 = cs.GetObservable()->Subscribe([&](int v) mutable
+        {
+            concurrent.emplace_back(v);
+            if (v == 3) d5->Dispose();
+        });
+        cs.OnNextBatch(batch, 5);
+        bool test4 = concurrent == std::vector<int>{1, 2, 3};
+
+        d1 = d2 = d4 = d5 = nullptr;
+        d3->Dispose();
+
+        return {test1 && test2 && test3 && test4, "BatchDisposeTest"};
+    }
+
+    // 別スレッドで解放されたブロックが確保側へ戻り、プールが伸び続けないことのテスト
+    static TestResult CrossThreadPoolTest()
+    {
+        constexpr size_t blockSize = 48;
+        constexpr size_t perRound = 20000;
+        constexpr int rounds = 20;
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::vector<void*> handoff;
+        int freedRounds = 0;
+        bool done = false;
+
+        // 受け取ったブロックを解放するだけのスレッド
+        std::thread consumer([&]
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true)
+            {
+                condition.wait(lock, [&] { return done || !handoff.empty(); });
+                if (handoff.empty()) break;
+
+                auto blocks = std::move(handoff);
+                handoff.clear();
+                lock.unlock();
+                for (auto p : blocks)
+                {
+                    RxPool::Deallocate(p, blockSize);
+                }
+                lock.lock();
+
+                ++freedRounds;
+                condition.notify_all();
+            }
+        });
+
+        size_t warmed = 0;
+        for (int round = 0; round < rounds; ++round)
+        {
+            std::vector<void*> blocks(perRound);
+            for (auto&& p : blocks)
+            {
+                p = RxPool::Allocate(blockSize);
+            }
+
+            std::unique_lock<std::mutex> lock(mutex);
+            handoff = std::move(blocks);
+            condition.notify_all();
+            condition.wait(lock, [&] { return freedRounds == round + 1; });
+
+            if (round == 2) warmed = RxPool::GlobalAllocationCount();
+        }
+        const auto after = RxPool::GlobalAllocationCount();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            done = true;
+        }
+        condition.notify_all();
+        consumer.join();
+
+        // 温まった後は新しいチャンクを確保しない
+        return {after == warmed, "CrossThreadPoolTest"};
+    }
+
+    // Zip 溢れテスト
+    static TestResult ZipOverflowTest()
+    {
+        std::vector<std::tuple<int, int>> res;
+        bool completed = false;
+        const auto stats = std::make_shared<BackpressureStats>();
+
+        const auto a = std::make_shared<Subject<int>>();
+        const auto b = std::make_shared<Subject<int>>();
+        a->GetObservable()
+         ->Zip(3, stats, b->GetObservable())
+         ->Subscribe([&](const std::tuple<int, int>& t) mutable { res.emplace_back(t); },
+                     [&]() mutable { completed = true; });
+
+        // 実行処理
+        // aが容量を超えて先行した分(4, 5)は捨てて数え、溜まっている分の組の対応は崩さない
+        for (int i = 1; i <= 5; ++i) a->OnNext(i);
+        bool test1 = res.empty() && stats->Dropped() == 2;
+
+        b->OnNext(10);
+        b->OnNext(20);
+        bool test2 = res == std::vector<std::tuple<int, int>>{std::make_tuple(1, 10), std::make_tuple(2, 20)};
+
+        // 空きができたら再び積める
+        a->OnNext(6);
+        b->OnNext(30);
+        b->OnNext(40);
+        bool test3 = res.size() == 4 && res[2] == std::make_tuple(3, 30) && res[3] == std::make_tuple(6, 40) && stats->Dropped() == 2;
+
+        // bが先行した場合も同様
+        for (int i = 0; i < 4; ++i) b->OnNext(50 + i);
+        bool test4 = stats->Dropped() == 3;
+
+        a->OnCompleted();
+        bool test5 = completed && res.size() == 4;
+
+        return {test1 && test2 && test3 && test4 && test5, "ZipOverflowTest"};
+    }
+
+    // 購読ごとの廃棄テスト
+    static TestResult SubscriptionDisposeTest()
+    {
+        // 実行処理
+        // 再生中にTakeで止めた後も、同じObservableから購読し直せる
+        std::vector<int> res1;
+        std::vector<int> res2;
+        const auto replay = std::make_shared<ReplaySubject<int>>(3);
+        replay->OnNext(1);
+        replay->OnNext(2);
+        const auto first = replay->GetObservable()->Take(1);
+        auto d1 = first->Subscribe([&](int v) mutable { res1.emplace_back(v); });
+        auto d2 = first->Subscribe([&](int v) mutable { res2.emplace_back(v); });
+        replay->OnNext(3);
+        bool test1 = res1 == std::vector<int>{1} && res2 == std::vector<int>{1} && d1->IsDisposed() && d2->IsDisposed();
+
+        // Takeが廃棄するのは自身の購読だけで、同じObservableからの他の購読には流れ続ける
+        std::vector<int> res3;
+        std::vector<int> res4;
+        const auto subject = std::make_shared<Subject<int>>();
+        const auto observable = subject->GetObservable();
+        observable->Take(1)->Subscribe([&](int v) mutable { res3.emplace_back(v); });
+        auto d4 = observable->Subscribe([&](int v) mutable { res4.emplace_back(v); });
+        subject->Pipe(PipeOp::Take(1))->Subscribe([&](int v) mutable { res3.emplace_back(v * 10); });
+        subject->OnNext(1);
+        subject->OnNext(2);
+        bool test2 = res3 == std::vector<int>{1, 10} && res4 == std::vector<int>{1, 2} && !d4->IsDisposed();
+
+        // Observable全体の廃棄は取り消されない (後から購読したものは登録と同時に廃棄される)
+        observable->GetDisposable()->Dispose();
+        auto d5 = observable->Subscribe([&](int v) mutable { res4.emplace_back(v); });
+        subject->OnNext(3);
+        bool test3 = d4->IsDisposed() && d5->IsDisposed() && res4 == std::vector<int>{1, 2};
+
+        // RefCountも同様
+        std::vector<int> res5;
+        const auto shared = subject->GetObservable()->Share();
+        shared->GetDisposable()->Dispose();
+        auto d6 = shared->Subscribe([&](int v) mutable { res5.emplace_back(v); });
+        subject->OnNext(4);
+        bool test4 = d6->IsDisposed() && res5.empty();
+
+        // ConcurrentSubjectも同様 (Takeの廃棄で同じObservableからの他の購読が外れない)
+        std::vector<int> res6;
+        std::vector<int> res7;
+        ConcurrentSubject<int> concurrent;
+        const auto concurrentObservable = concurrent.GetObservable();
+        auto d7 = concurrentObservable->Take(1)->Subscribe([&](int v) mutable { res6.emplace_back(v); });
+        auto d8 = concurrentObservable->Subscribe([&](int v) mutable { res7.emplace_back(v); });
+        concurrent.OnNext(1);
+        concurrent.OnNext(2);
+        concurrent.OnNext(3);
+        bool test5 = res6 == std::vector<int>{1} && res7 == std::vector<int>{1, 2, 3} &&
+                     d7->IsDisposed() && !d8->IsDisposed() && concurrent.SubscriberCount() == 1;
+
+        concurrentObservable->GetDisposable()->Dispose();
+        auto d9 = concurrentObservable->Subscribe([&](int v) mutable { res7.emplace_back(v); });
+        concurrent.OnNext(4);
+        bool test6 = d8->IsDisposed() && d9->IsDisposed() && res7 == std::vector<int>{1, 2, 3} &&
+                     concurrent.SubscriberCount() == 0;
+
+        return {test1 && test2 && test3 && test4 && test5 && test6, "SubscriptionDisposeTest"};
+    }
+
+    // Pipe Where Chain テスト
+    static TestResult PipeWhereChainTest()
+    {
+        int res = -1;
+
+        const auto subject = std::make_shared<Subject<std::string>>();
+        auto _ = subject->Pipe(PipeOp::Select([](const std::string& s) { return atoi(s.c_str()); }),
+                               PipeOp::Where([](int i) { return i > 0; }))
+                        ->Subscribe([&](int i) mutable
+                        {
+                            res = i;
+                        });
+
+        // 実行処理
+        subject->OnNext("123");
+        bool test1 = res == 123;
+
+        subject->OnNext("0");
+        bool test2 = res == 123;
+
+        subject->OnNext("-456");
+        bool test3 = res == 123;
+
+        return {test1 && test2 && test3, "PipeWhereChainTest"};
+    }
+
+    // Pipe Select Chain テスト
+    static TestResult PipeSelectChainTest()
+    {
+        int res = -1;
+
+        const auto subject = std::make_shared<Subject<std::string>>();
+        auto _ = subject->Pipe(PipeOp::Where([](const std::string& s) { return s == "123"; }),
+                               PipeOp::Select([](const std::string& s) { return atoi(s.c_str()); }))
+                        ->Subscribe([&](int i) mutable
+                        {
+                            res = i;
+                        });
+
+        // 実行処理
+        subject->OnNext("123");
+        bool test1 = res == 123;
+
+        subject->OnNext("0");
+        bool test2 = res == 123;
+
+        subject->OnNext("-456");
+        bool test3 = res == 123;
+
+        return {test1 && test2 && test3, "PipeSelectChainTest"};
+    }
+
+    // Pipe Skip Chain テスト
+    static TestResult PipeSkipChainTest()
+    {
+        int res = -1;
+
+        const auto subject = std::make_shared<Subject<std::string>>();
+        auto _ = subject->Pipe(PipeOp::Select([](const std::string& s) { return atoi(s.c_str()); }),
+                               PipeOp::Skip(2),
+                               PipeOp::Where([](int i) { return i > 0; }))
+                        ->Subscribe([&](int i) mutable
+                        {
+                            res = i;
+                        });
+
+        // 実行処理
+        subject->OnNext("123");
+        bool test1 = res == -1;
+
+        subject->OnNext("123");
+        bool test2 = res == -1;
+
+        subject->OnNext("123");
+        bool test3 = res == 123;
+
+        subject->OnNext("456");
+        bool test4 = res == 456;
+
+        return {test1 && test2 && test3 && test4, "PipeSkipChainTest"};
+    }
+
+    // Pipe Take Chain テスト
+    static TestResult PipeTakeChainTest()
+    {
+        int res = -1;
+        bool completed = false;
+
+        const auto subject = std::make_shared<Subject<std::string>>();
+        auto _ = subject->Pipe(PipeOp::Select([](const std::string& s) { return atoi(s.c_str()); }),
+                               PipeOp::Take(2),
+                               PipeOp::Where([](int i) { return i > 0; }))
+                        ->Subscribe([&](int i) mutable
+                                    {
+                                        res = i;
+                                    },
+                                    [&]() mutable
+                                    {
+                                        completed = true;
+                                    });
+
+        // 実行処理
+        subject->OnNext("123");
+        bool test1 = res == 123;
+
+        subject->OnNext("456");
+        bool test2 = res == 456 && completed;
+
+        subject->OnNext("789");
+        bool test3 = res == 456;
+
+        // オペレータのTakeと同じ結果になる (完了済みのReplaySubjectでも完了は1回、Take(0)は最初の1つを流す)
+        const auto run = [](bool pipe, int count)
+        {
+            std::vector<int> values;
+            int completedCount = 0;
+            ReplaySubject<int> replay(3);
+            replay.OnNext(1);
+            replay.OnNext(2);
+            replay.OnCompleted();
+            const auto onNext = [&](int i) mutable { values.emplace_back(i); };
+            const auto onCompleted = [&]() mutable { completedCount++; };
+            auto d = pipe ? replay.Pipe(PipeOp::Take(count))->Subscribe(onNext, onCompleted)
+                          : replay.GetObservable()->Take(count)->Subscribe(onNext, onCompleted);
+            return std::make_pair(values, completedCount);
+        };
+        bool test4 = run(true, 1) == run(false, 1) && run(true, 1).second == 1;
+        bool test5 = run(true, 0) == run(false, 0) && run(true, 0).first == std::vector<int>{1};
+
+        return {test1 && test2 && test3 && test4 && test5, "PipeTakeChainTest"};
+    }
+
+    // Pipe Interval Chain テスト
+    static TestResult PipeIntervalChainTest()
+    {
+        int res = -1;
+
+        const auto subject = std::make_shared<Subject<std::string>>();
+        auto _ = subject->Pipe(PipeOp::Select([](const std::string& s) { return atoi(s.c_str()); }),
+                               PipeOp::Interval(2),
+                               PipeOp::Where([](int i) { return i > 0; }))
+                        ->Subscribe([&](int i) mutable
+                        {
+                            res = i;
+                        });
+
+        // 実行処理
+        subject->OnNext("123");
+        bool test1 = res == -1;
+
+        subject->OnNext("123");
+        bool test2 = res == 123;
+
+        subject->OnNext("456");
+        bool test3 = res == 123;
+
+        subject->OnNext("456");
+        bool test4 = res == 456;
+
+        return {test1 && test2 && test3 && test4, "PipeIntervalChainTest"};
+    }
+
+    // Pipe 5段チェーン テスト (EnemySampleと同じ構成を両モードで比較)
+    static TestResult PipeLongChainTest()
+    {
+        std::vector<int> res1, res2;
+
+        const auto subject = std::make_shared<Subject<int>>();
+        auto d1 = subject->GetObservable()
+                         ->Where([](int i) { return i % 2 == 0; })
+                         ->Skip(3)
+                         ->Interval(3)
+                         ->Take(3)
+                         ->Subscribe([&](int i) mutable
+                         {
+                             res1.emplace_back(i);
+                         });
+
+        auto d2 = subject->Pipe(PipeOp::Where([](int i) { return i % 2 == 0; }),
+                                PipeOp::Skip(3),
+                                PipeOp::Interval(3),
+                                PipeOp::Take(3))
+                         ->Subscribe([&](int i) mutable
+                         {
+                             res2.emplace_back(i);
+                         });
+
+        // 実行処理
+        for (int i = 0; i < 50; i++)
+        {
+            subject->OnNext(i);
+        }
+
+        return {res1.size() == 3 && res1 == res2, "PipeLongChainTest"};
+    }
     
     static void DoTest()
     {
@@ -425,5 +2944,61 @@ namespace Test
         IsClear(DisposeTest());
         IsClear(AddToTest());
         IsClear(ColdObservableTest());
+        IsClear(ManySubscribeDisposeTest());
+        IsClear(ReentrantDisposeTest());
+        IsClear(NoCopyPropagationTest());
+        IsClear(PoolAllocationTest());
+        IsClear(ConcurrentSubjectStressTest());
+        IsClear(OnNextBatchTest());
+        IsClear(OnNextBatchStringTest());
+        IsClear(ObserveOnMainThreadTest());
+        IsClear(ObserveOnThreadPoolTest());
+        IsClear(SubscribeOnTest());
+        IsClear(CurrentThreadSchedulerTest());
+        IsClear(FrameTimerWheelTest());
+        IsClear(FrameOperatorTest());
+        IsClear(AddToMultipleTest());
+        IsClear(CompositeDisposableTest());
+        IsClear(InstrumentationTest());
+        IsClear(TraceTest());
+        IsClear(BufferTest());
+        IsClear(BufferFrameTest());
+        IsClear(WindowTest());
+        IsClear(BackpressureTest());
+        IsClear(BackpressureThreadPoolTest());
+        IsClear(ThrottleFrameTest());
+        IsClear(ThrottleTimeTest());
+        IsClear(DistinctUntilChangedTest());
+        IsClear(MergeTest());
+        IsClear(CombineLatestTest());
+        IsClear(ZipTest());
+        IsClear(BehaviorSubjectTest());
+        IsClear(ReplaySubjectTest());
+        IsClear(ResubscribeAfterDisposeTest());
+        IsClear(PublishTest());
+        IsClear(ShareTest());
+        IsClear(ParallelDispatchTest());
+        IsClear(FunctionInlineTest());
+        IsClear(DownstreamOwnershipTest());
+        IsClear(RecordReplayTest());
+        IsClear(MappedFileTest());
+        IsClear(SubscriptionOrderTest());
+        IsClear(BatchDisposeTest());
+        IsClear(CrossThreadPoolTest());
+        IsClear(ZipOverflowTest());
+        IsClear(SubscriptionDisposeTest());
+#if RX_COROUTINES
+        IsClear(CoroutineFramesTest());
+        IsClear(FirstAsyncTest());
+        IsClear(CoroutineCancelTest());
+        IsClear(CoroutinePoolTest());
+#endif
+
+        IsClear(PipeWhereChainTest());
+        IsClear(PipeSelectChainTest());
+        IsClear(PipeSkipChainTest());
+        IsClear(PipeTakeChainTest());
+        IsClear(PipeIntervalChainTest());
+        IsClear(PipeLongChainTest());
     }
 };
@@ -0,0 +1,275 @@
+#include "Trace.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Trace
+{
+    namespace
+    {
+        std::mutex histogramMutex;
+
+        std::vector<LatencyHistogram*>& Histograms()
+        {
+            static std::vector<LatencyHistogram*> histograms;
+            return histograms;
+        }
+    }
+
+#if RX_TRACING
+    namespace
+    {
+        struct Event
+        {
+            const char* name;
+            uint64_t begin;
+            uint64_t end;
+        };
+
+        // スレッドごとのリングバッファ (書き込むのは所有スレッドのみ)
+        struct ThreadBuffer
+        {
+            static constexpr size_t Capacity = 1 << 16;
+
+            uint32_t tid;
+            std::atomic<uint64_t> written{0};
+            std::vector<Event> events = std::vector<Event>(Capacity);
+        };
+
+        // クロックの換算用の基準点
+        struct Calibration
+        {
+            uint64_t ticks;
+            uint64_t ns;
+            double nsPerTick; // 起点で短時間測った換算値
+
+            Calibration(): ticks(Now()), ns(NowSteady())
+            {
+                // 1ms程度回して大まかな換算値を求めておく
+                uint64_t nowNs;
+                do
+                {
+                    nowNs = NowSteady();
+                }
+                while (nowNs - ns < 1000000);
+                nsPerTick = static_cast<double>(nowNs - ns) / static_cast<double>(Now() - ticks);
+            }
+        };
+
+        const Calibration& Origin()
+        {
+            static const Calibration origin;
+            return origin;
+        }
+
+        // 最初の区間に換算値の計測時間が入らないよう、起動時に済ませておく
+        const Calibration& originAtStartup = Origin();
+
+        std::mutex bufferMutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers; // 終了したスレッドの分も書き出せるよう保持し続ける
+
+        ThreadBuffer& LocalBuffer()
+        {
+            static thread_local ThreadBuffer* local = nullptr;
+            if (local != nullptr) return *local;
+
+            auto buffer = std::make_shared<ThreadBuffer>();
+            std::lock_guard<std::mutex> lock(bufferMutex);
+            buffer->tid = static_cast<uint32_t>(buffers.size() + 1);
+            buffers.push_back(buffer);
+            local = buffer.get();
+            return *local;
+        }
+
+        // 1tickあたりのナノ秒 (起点からの経過で測り直す)
+        double NsPerTick()
+        {
+            const auto& origin = Origin();
+            const auto ticks = Now() - origin.ticks;
+            const auto ns = NowSteady() - origin.ns;
+
+            // 起点から十分経つまでは起点で測った値を使う
+            if (ns < 100000000) return origin.nsPerTick;
+            return static_cast<double>(ns) / static_cast<double>(ticks);
+        }
+    }
+
+    uint64_t NowSteady()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    double TicksToNs(uint64_t ticks)
+    {
+        // 毎回測り直すと重いので、一定回数ごとに更新する
+        static thread_local double nsPerTick = 0;
+        static thread_local uint32_t uses = 0;
+        if (uses++ % 4096 == 0) nsPerTick = NsPerTick();
+        return static_cast<double>(ticks) * nsPerTick;
+    }
+
+    void Record(const char* name, uint64_t begin, uint64_t end)
+    {
+        auto& buffer = LocalBuffer();
+        const auto w = buffer.written.load(std::memory_order_relaxed);
+        buffer.events[w % ThreadBuffer::Capacity] = Event{name, begin, end};
+        buffer.written.store(w + 1, std::memory_order_release);
+    }
+
+    void WriteChromeTrace(std::ostream& os)
+    {
+        const auto origin = Origin().ticks;
+        const auto nsPerTick = NsPerTick();
+        const auto toUs = [&](uint64_t t)
+        {
+            // 起点より前に始まった区間もあるので符号付きで扱う
+            return static_cast<double>(static_cast<int64_t>(t - origin)) * nsPerTick / 1000.0;
+        };
+
+        std::lock_guard<std::mutex> lock(bufferMutex);
+
+        os << "{\"traceEvents\": [";
+        bool first = true;
+        for (auto&& buffer : buffers)
+        {
+            const auto written = buffer->written.load(std::memory_order_acquire);
+            const auto count = written < ThreadBuffer::Capacity ? written : ThreadBuffer::Capacity;
+
+            for (auto i = written - count; i < written; ++i)
+            {
+                auto&& e = buffer->events[i % ThreadBuffer::Capacity];
+                os << (first ? "\n" : ",\n") << "  {\"name\": \"" << e.name << "\", \"ph\": \"X\", \"ts\": "
+                    << toUs(e.begin) << ", \"dur\": " << toUs(e.end) - toUs(e.begin) << ", \"pid\": 1, \"tid\": "
+                    << buffer->tid << "}";
+                first = false;
+            }
+        }
+        os << "\n], \"displayTimeUnit\": \"ns\"}\n";
+    }
+
+    void Clear()
+    {
+        std::lock_guard<std::mutex> lock(bufferMutex);
+        for (auto&& buffer : buffers)
+        {
+            buffer->written.store(0, std::memory_order_release);
+        }
+    }
+
+    LatencyHistogram::LatencyHistogram(const char* name): name(name), count(0)
+    {
+        for (auto&& b : buckets)
+        {
+            b.store(0, std::memory_order_relaxed);
+        }
+
+        std::lock_guard<std::mutex> lock(histogramMutex);
+        Histograms().push_back(this);
+    }
+
+    void LatencyHistogram::RecordNs(double ns)
+    {
+        // 区間iは [2^(i-1), 2^i) ns
+        auto v = ns > 0 ? static_cast<uint64_t>(ns) : 0;
+        size_t index = 0;
+        while (v > 0 && index < BucketCount - 1)
+        {
+            v >>= 1;
+            ++index;
+        }
+
+        buckets[index].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t LatencyHistogram::Count() const
+    {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    double LatencyHistogram::Percentile(double p) const
+    {
+        const auto total = Count();
+        if (total == 0) return 0;
+
+        const auto target = static_cast<uint64_t>(p * static_cast<double>(total) + 0.5);
+        uint64_t sum = 0;
+        for (size_t i = 0; i < BucketCount; ++i)
+        {
+            sum += buckets[i].load(std::memory_order_relaxed);
+            if (sum >= target && sum > 0) return static_cast<double>(1ull << i);
+        }
+        return static_cast<double>(1ull << (BucketCount - 1));
+    }
+
+    void LatencyHistogram::Reset()
+    {
+        for (auto&& b : buckets)
+        {
+            b.store(0, std::memory_order_relaxed);
+        }
+        count.store(0, std::memory_order_relaxed);
+    }
+#else
+    void WriteChromeTrace(std::ostream& os)
+    {
+        os << "{\"traceEvents\": [\n], \"displayTimeUnit\": \"ns\"}\n";
+    }
+
+    void Clear()
+    {
+    }
+
+    LatencyHistogram::LatencyHistogram(const char* name): name(name)
+    {
+        std::lock_guard<std::mutex> lock(histogramMutex);
+        Histograms().push_back(this);
+    }
+
+    void LatencyHistogram::RecordNs(double)
+    {
+    }
+
+    uint64_t LatencyHistogram::Count() const
+    {
+        return 0;
+    }
+
+    double LatencyHistogram::Percentile(double) const
+    {
+        return 0;
+    }
+
+    void LatencyHistogram::Reset()
+    {
+    }
+#endif
+
+    LatencyHistogram::~LatencyHistogram()
+    {
+        std::lock_guard<std::mutex> lock(histogramMutex);
+        auto& histograms = Histograms();
+        for (auto itr = histograms.begin(); itr != histograms.end(); ++itr)
+        {
+            if (*itr != this) continue;
+
+            histograms.erase(itr);
+            break;
+        }
+    }
+
+    void WriteLatency(std::ostream& os)
+    {
+        std::lock_guard<std::mutex> lock(histogramMutex);
+
+        os << "name,count,p50_ns,p90_ns,p99_ns\n";
+        for (auto&& h : Histograms())
+        {
+            os << h->Name() << ',' << h->Count() << ',' << h->Percentile(0.5) << ',' << h->Percentile(0.9) << ','
+                << h->Percentile(0.99) << '\n';
+        }
+    }
+}
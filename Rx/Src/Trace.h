@@ -0,0 +1,139 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <utility>
+
+// OnNextの伝播をChromeのトレース形式(chrome://tracing, Perfetto)で記録するトレース機能
+// CMakeのRX_TRACINGオプション(RX_TRACING=1)で有効になり、計測(Instrumentation.h)も合わせて有効になる
+// 記録はスレッドごとのリングバッファへ書き込むだけでロックを取らない (古いものから上書きされる)
+// 無効時は何も生成されない
+#ifndef RX_TRACING
+#define RX_TRACING 0
+#endif
+
+#if RX_TRACING && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#elif RX_TRACING && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace Trace
+{
+#if RX_TRACING
+    uint64_t NowSteady();
+
+    // 安価な単調増加クロック (x86ではTSC、それ以外はsteady_clock)。書き出し時にナノ秒へ換算する
+    inline uint64_t Now()
+    {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+        return __rdtsc();
+#else
+        return NowSteady();
+#endif
+    }
+
+    // Now()の差をナノ秒に換算する
+    double TicksToNs(uint64_t ticks);
+
+    // 区間を記録する (nameは文字列リテラル等、書き出しまで生存するもの)
+    void Record(const char* name, uint64_t begin, uint64_t end);
+
+    // スコープの開始から終了までを1つの区間として記録する
+    class Scope
+    {
+        const char* name;
+        uint64_t begin;
+
+    public:
+        explicit Scope(const char* name): name(name), begin(Now())
+        {
+        }
+
+        ~Scope()
+        {
+            Record(name, begin, Now());
+        }
+    };
+#else
+    class Scope
+    {
+    public:
+        explicit Scope(const char*)
+        {
+        }
+    };
+#endif
+
+    // 記録した区間をChromeのトレースJSONとして書き出す (記録中のスレッドが止まっている時に呼ぶこと)
+    void WriteChromeTrace(std::ostream& os);
+
+    // 記録した区間を全て破棄する
+    void Clear();
+
+    // 発行時刻を刻んだ値。スレッドやキューを跨いでも、受け取った側で発行からの遅延を測れる
+    template <typename T>
+    struct Stamped
+    {
+        T value;
+#if RX_TRACING
+        uint64_t stamp;
+#endif
+    };
+
+    template <typename T>
+    Stamped<T> Stamp(T value)
+    {
+#if RX_TRACING
+        return Stamped<T>{std::move(value), Now()};
+#else
+        return Stamped<T>{std::move(value)};
+#endif
+    }
+
+    // 発行から受け取りまでの遅延のヒストグラム (2のべき乗ナノ秒ごとの区間で数える)
+    // 生成時に登録され、WriteLatencyでまとめて出力できる。staticに置いて使う想定
+    class LatencyHistogram
+    {
+    public:
+        static constexpr size_t BucketCount = 64;
+
+    private:
+        const char* name;
+#if RX_TRACING
+        std::array<std::atomic<uint64_t>, BucketCount> buckets;
+        std::atomic<uint64_t> count;
+#endif
+
+    public:
+        explicit LatencyHistogram(const char* name);
+        ~LatencyHistogram();
+
+        LatencyHistogram(const LatencyHistogram&) = delete;
+        LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+        template <typename T>
+        void Record(const Stamped<T>& v)
+        {
+#if RX_TRACING
+            RecordNs(TicksToNs(Now() - v.stamp));
+#else
+            (void)v;
+#endif
+        }
+
+        void RecordNs(double ns);
+
+        const char* Name() const { return name; }
+        uint64_t Count() const;
+
+        // 指定の割合(0-1)の値が収まる区間の上限(ns)
+        double Percentile(double p) const;
+
+        void Reset();
+    };
+
+    // 登録されている全てのヒストグラムの件数/p50/p90/p99を書き出す
+    void WriteLatency(std::ostream& os);
+}
@@ -71,6 +71,7 @@ int main()
 
     // メモリーリークチェックのタイミングではリークとして検知されてしまうので解放しておく
     ObservableUtil::everyUpdateSubject = nullptr;
+    FrameTimerWheel::Main().Clear();
 
 //    _CrtDumpMemoryLeaks(); // メモリリークチェック用
 }